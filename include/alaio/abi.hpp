@@ -14,6 +14,7 @@
 #include "time.hpp"
 #include "bytes.hpp"
 #include "asset.hpp"
+#include "bin_view.hpp"
 
 namespace alaio {
 
@@ -58,6 +59,12 @@ void from_bin(might_not_exist<T>& obj, S& stream) {
       return from_bin(obj.value, stream);
 }
 
+template <typename T, typename S>
+void skip_bin(might_not_exist<T>*, S& stream) {
+   if (stream.remaining())
+      return skip_bin((T*)nullptr, stream);
+}
+
 template <typename T, typename S>
 void to_bin(const might_not_exist<T>& obj, S& stream) {
    return to_bin(obj.value, stream);
@@ -240,6 +247,13 @@ struct abi_type {
          std::string_view json, std::function<void()> f = [] {}) const;
    std::vector<char> json_to_bin_reorderable(
          std::string_view json, std::function<void()> f = [] {}) const;
+
+   // Advances bin past one value of this type without converting it
+   void skip_bin(input_stream& bin) const;
+
+   // Indexes a value of this array type; bin starts at the array's size and is left after the array.
+   // array_of()->bin_to_json() converts any element.
+   bin_array_index index_array(input_stream& bin) const;
 };
 
 struct abi {
@@ -339,6 +353,9 @@ abi_type* add_type(abi& a, std::optional<T>*) {
    return &iter->second;
 }
 
+// string_view fields reference the serialized data but have the same abi type as std::string
+inline abi_type* add_type(abi& a, std::string_view*) { return add_type(a, (std::string*)nullptr); }
+
 template <typename T>
 abi_type* add_type(abi& a, might_not_exist<T>*) {
    auto element_type = a.add_type<T>();
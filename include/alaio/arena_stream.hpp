@@ -0,0 +1,72 @@
+#pragma once
+
+#include "from_bin.hpp"
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace alaio {
+
+/**
+ * input_stream whose from_bin allocates std::pmr containers from resource. Containers are moved onto resource before
+ * they are filled, so nested containers inside structs, optionals and variants also use it. With a
+ * std::pmr::monotonic_buffer_resource, decoding a whole block bump-allocates and everything is freed by one release():
+ *
+ *    std::pmr::monotonic_buffer_resource arena;
+ *    for (auto& block : blocks) {
+ *       {
+ *          arena_input_stream stream{ block.traces, &arena };
+ *          std::pmr::vector<ship_protocol::pmr::transaction_trace> traces;
+ *          from_bin(traces, stream);
+ *          ...
+ *       }
+ *       arena.release();
+ *    }
+ *
+ * Decoded objects must be destroyed, or at least no longer used, before the resource releases its memory.
+ */
+struct arena_input_stream : input_stream {
+   std::pmr::memory_resource* resource = std::pmr::get_default_resource();
+
+   arena_input_stream() = default;
+   arena_input_stream(input_stream stream, std::pmr::memory_resource* resource)
+       : input_stream{ stream }, resource{ resource } {}
+};
+
+// Makes an empty c use resource. Containers usually arrive here default-constructed, so nothing is freed.
+template <typename C>
+void use_resource(C& c, std::pmr::memory_resource* resource) {
+   if (c.get_allocator().resource() != resource) {
+      c.~C();
+      new (&c) C(resource);
+   }
+}
+
+template <typename T>
+void from_bin(std::pmr::vector<T>& v, arena_input_stream& stream) {
+   use_resource(v, stream.resource);
+   uint32_t size;
+   varuint32_from_bin(size, stream);
+   if constexpr (has_bitwise_serialization<T>()) {
+      stream.check_available(uint64_t(size) * sizeof(T));
+      v.resize(size);
+      stream.read(reinterpret_cast<char*>(v.data()), size * sizeof(T));
+   } else {
+      v.resize(size);
+      for (auto& x : v) {
+         from_bin(x, stream);
+      }
+   }
+}
+
+inline void from_bin(std::pmr::string& obj, arena_input_stream& stream) {
+   use_resource(obj, stream.resource);
+   uint32_t size;
+   varuint32_from_bin(size, stream);
+   stream.check_available(size);
+   obj.resize(size);
+   stream.read(obj.data(), obj.size());
+}
+
+} // namespace alaio
@@ -344,7 +344,13 @@ inline void from_string(asset& result, S& stream) {
 
 template <typename S>
 void to_json(const asset& obj, S& stream) {
-   to_json(asset_to_string(obj.amount, obj.symbol.value), stream);
+   char  buf[asset_max_size + 2];
+   char* end = asset_to_chars(obj.amount, obj.symbol.value, buf + 1);
+   if (!symbol_code_is_json_safe(obj.symbol.value >> 8))
+      return to_json(std::string_view{ buf + 1, std::size_t(end - buf - 1) }, stream);
+   buf[0] = '"';
+   *end++ = '"';
+   stream.write(buf, end - buf);
 }
 
 template <typename S>
@@ -0,0 +1,362 @@
+#pragma once
+
+#include "from_bin.hpp"
+#include "map_macro.h"
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace alaio {
+
+/**
+ * Read-only view of a serialized reflected struct. Fields are located on first access by skipping the fields before
+ * them; offsets found along the way are kept, so reading fields in declaration order touches each byte once.
+ *
+ *    bin_view<transaction_trace_v0> trace{ stream };
+ *    auto id            = trace.get<&transaction_trace_v0::id>();            // decoded: checksum256
+ *    auto action_traces = trace.get<&transaction_trace_v0::action_traces>(); // bin_vector_view, nothing decoded
+ *
+ * get() returns a bin_view_t of the field's type: plain values are decoded, std::string becomes std::string_view,
+ * vectors become bin_vector_view, and optionals, variants and structs holding any of these become views themselves.
+ * A view refers to the serialized data, which must outlive it. Views cache offsets in mutable members, so a view
+ * object must not be shared between threads; copies are independent.
+ */
+template <typename T>
+class bin_view;
+
+template <typename T>
+class bin_vector_view;
+
+template <typename T>
+class bin_vector_index;
+
+template <typename T, typename = void>
+struct bin_view_traits;
+
+template <typename T>
+using bin_view_t = typename bin_view_traits<T>::type;
+
+// ALAIO_BIN_VIEW declares a named view through an overload of this function
+template <typename T>
+bin_view<T> bin_view_for(T*);
+
+template <typename T, auto Member>
+constexpr int bin_view_field_index() {
+   int result = -1, i = 0;
+   alaio_for_each_field((T*)nullptr, [&](const char*, auto member) {
+      using M = decltype(member((T*)nullptr));
+      if constexpr (std::is_member_object_pointer_v<M>) {
+         if constexpr (std::is_same_v<M, decltype(Member)>) {
+            if (member((T*)nullptr) == Member)
+               result = i;
+         }
+         ++i;
+      }
+   });
+   return result;
+}
+
+// True for reflected structs with at least one field which is not decoded as-is
+template <typename T>
+constexpr bool bin_view_is_composite() {
+   if constexpr (has_bitwise_serialization<T>() || !std::is_same_v<serialization_type<T>, void> ||
+                 !reflection::has_for_each_field_v<T>) {
+      return false;
+   } else {
+      bool result = false;
+      alaio_for_each_field((T*)nullptr, [&](const char*, auto member) {
+         using M = decltype(member((T*)nullptr));
+         if constexpr (std::is_member_object_pointer_v<M>) {
+            using F = reflection::member_object_type_t<M>;
+            if constexpr (!std::is_same_v<bin_view_t<F>, F>)
+               result = true;
+         }
+      });
+      return result;
+   }
+}
+
+// Decodes
+template <typename T, typename>
+struct bin_view_traits {
+   using type = T;
+   static type read(input_stream stream) {
+      T obj;
+      from_bin(obj, stream);
+      return obj;
+   }
+};
+
+template <typename T>
+struct bin_view_traits<T, std::enable_if_t<bin_view_is_composite<T>()>> {
+   using type = decltype(bin_view_for((T*)nullptr));
+   static type read(input_stream stream) { return type{ stream }; }
+};
+
+template <>
+struct bin_view_traits<std::string> {
+   using type = std::string_view;
+   static type read(input_stream stream) {
+      std::string_view result;
+      from_bin(result, stream);
+      return result;
+   }
+};
+
+template <typename T>
+struct bin_view_traits<std::vector<T>> {
+   using type = bin_vector_view<T>;
+   static type read(input_stream stream) { return type{ stream }; }
+};
+
+template <typename T>
+struct bin_view_traits<std::optional<T>> {
+   using type = std::optional<bin_view_t<T>>;
+   static type read(input_stream stream) {
+      bool present;
+      from_bin(present, stream);
+      if (!present)
+         return {};
+      return bin_view_traits<T>::read(stream);
+   }
+};
+
+template <typename... Ts>
+struct bin_view_traits<std::variant<Ts...>> {
+   using type = std::variant<bin_view_t<Ts>...>;
+   static type read(input_stream stream) {
+      uint32_t i;
+      varuint32_from_bin(i, stream);
+      return read<0>(i, stream);
+   }
+
+ private:
+   template <uint32_t I>
+   static type read(uint32_t i, input_stream stream) {
+      if constexpr (I < sizeof...(Ts)) {
+         if (i == I)
+            return type{ std::in_place_index<I>,
+                         bin_view_traits<std::variant_alternative_t<I, std::variant<Ts...>>>::read(stream) };
+         return read<I + 1>(i, stream);
+      } else {
+         check( false, convert_stream_error(stream_error::bad_variant_index) );
+         __builtin_unreachable();
+      }
+   }
+};
+
+template <typename T>
+class bin_view {
+ public:
+   static constexpr int num_fields = reflection::num_fields<T>();
+
+   bin_view() = default;
+
+   // stream starts at the serialized object and may extend past it
+   explicit bin_view(input_stream stream) : end{ stream.end } { offsets[0] = stream.pos; }
+
+   template <auto Member>
+   auto get() const {
+      constexpr int i = bin_view_field_index<T, Member>();
+      static_assert(i >= 0, "get() needs a reflected member of T");
+      return bin_view_traits<reflection::member_object_type_t<decltype(Member)>>::read(field_stream(i));
+   }
+
+   // The serialized object followed by whatever came after it in the stream
+   input_stream data() const { return { offsets[0], end }; }
+
+   // Size of the serialized object; skips the fields which haven't been located yet
+   std::size_t size() const { return field_stream(num_fields).pos - offsets[0]; }
+
+   T decode() const {
+      T    obj;
+      auto stream = data();
+      from_bin(obj, stream);
+      return obj;
+   }
+
+ private:
+   mutable const char* offsets[num_fields + 1] = {};
+   mutable int         num_known               = 1;
+   const char*         end                     = nullptr;
+
+   input_stream field_stream(int i) const {
+      if (i >= num_known) {
+         input_stream stream{ offsets[num_known - 1], end };
+         int          field = 0;
+         alaio_for_each_field((T*)nullptr, [&](const char*, auto member) {
+            using M = decltype(member((T*)nullptr));
+            if constexpr (std::is_member_object_pointer_v<M>) {
+               if (field >= num_known - 1 && field < i) {
+                  skip_bin((reflection::member_object_type_t<M>*)nullptr, stream);
+                  offsets[field + 1] = stream.pos;
+               }
+               ++field;
+            }
+         });
+         num_known = i + 1;
+      }
+      return { offsets[i], end };
+   }
+};
+
+/**
+ * Offsets of the elements of a serialized array, found in one pass which skips each element. Any element can then be
+ * read without touching the ones before it, and the array can be split into ranges for other threads. The index does
+ * not change after construction, so threads may share it. It refers to the serialized data, which must outlive it.
+ *
+ *    auto index = trace.action_traces().index();      // bin_vector_index<action_trace>
+ *    auto last  = index[index.size() - 1];            // bin_view_t<action_trace>
+ *    auto parts = index.partition(num_threads);
+ *    // thread i reads index.elements(parts[i], parts[i + 1])
+ */
+class bin_array_index {
+ public:
+   bin_array_index() = default;
+
+   // stream starts at the first of size elements; skip(stream) passes one element. stream is left after the last.
+   template <typename F>
+   bin_array_index(uint32_t size, input_stream& stream, F&& skip) : base{ stream.pos } {
+      offsets.reserve(std::min<uint64_t>(size, stream.remaining()) + 1);
+      for (uint32_t i = 0; i < size; ++i) {
+         skip(stream);
+         auto offset = stream.pos - base;
+         check(offset <= 0xffff'ffff, "array too large to index");
+         offsets.push_back(offset);
+      }
+   }
+
+   uint32_t size() const { return offsets.size() - 1; }
+   bool     empty() const { return offsets.size() == 1; }
+
+   // The serialized element i
+   input_stream element(uint32_t i) const { return { base + offsets[i], base + offsets[i + 1] }; }
+
+   // The serialized elements [first, last)
+   input_stream elements(uint32_t first, uint32_t last) const {
+      return { base + offsets[first], base + offsets[last] };
+   }
+
+   // Boundaries splitting the elements into at most n ranges of about the same size in bytes. The first boundary is 0
+   // and the last is size(); range i is [result[i], result[i + 1]).
+   std::vector<uint32_t> partition(uint32_t n) const {
+      std::vector<uint32_t> result{ 0 };
+      for (uint32_t i = 1; i < n; ++i) {
+         uint32_t target = uint64_t(offsets.back()) * i / n;
+         uint32_t b = std::lower_bound(offsets.begin() + result.back(), offsets.end(), target) - offsets.begin();
+         if (b > result.back() && b < size())
+            result.push_back(b);
+      }
+      result.push_back(size());
+      return result;
+   }
+
+ private:
+   const char*           base    = nullptr;
+   std::vector<uint32_t> offsets = { 0 };
+};
+
+// bin_array_index of a serialized std::vector<T> which also reads elements as bin_view_t<T>
+template <typename T>
+class bin_vector_index : public bin_array_index {
+ public:
+   using bin_array_index::bin_array_index;
+
+   bin_view_t<T> operator[](uint32_t i) const { return bin_view_traits<T>::read(element(i)); }
+};
+
+/**
+ * View of a serialized std::vector<T>. Iterating yields bin_view_t<T> for each element; moving to the next element
+ * skips the current one.
+ */
+template <typename T>
+class bin_vector_view {
+ public:
+   class iterator {
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type        = bin_view_t<T>;
+      using difference_type   = std::ptrdiff_t;
+      using pointer           = void;
+      using reference         = value_type;
+
+      iterator() = default;
+
+      value_type operator*() const { return bin_view_traits<T>::read(stream); }
+
+      iterator& operator++() {
+         skip_bin((T*)nullptr, stream);
+         ++index;
+         return *this;
+      }
+
+      friend bool operator==(const iterator& a, const iterator& b) { return a.index == b.index; }
+      friend bool operator!=(const iterator& a, const iterator& b) { return a.index != b.index; }
+
+    private:
+      friend bin_vector_view;
+      iterator(input_stream stream, uint32_t index) : stream{ stream }, index{ index } {}
+
+      input_stream stream;
+      uint32_t     index = 0;
+   };
+
+   bin_vector_view() = default;
+
+   // stream starts at the serialized vector's size and may extend past it
+   explicit bin_vector_view(input_stream stream) {
+      varuint32_from_bin(num_elements, stream);
+      elements = stream;
+   }
+
+   uint32_t size() const { return num_elements; }
+   bool     empty() const { return num_elements == 0; }
+   iterator begin() const { return { elements, 0 }; }
+   iterator end() const { return { {}, num_elements }; }
+
+   // Locates every element in one pass for random access
+   bin_vector_index<T> index() const {
+      input_stream stream = elements;
+      return bin_vector_index<T>(num_elements, stream, [](input_stream& s) { skip_bin((T*)nullptr, s); });
+   }
+
+   std::vector<T> decode() const {
+      std::vector<T> result;
+      input_stream   stream = elements;
+      if constexpr (has_bitwise_serialization<T>()) {
+         stream.check_available(uint64_t(num_elements) * sizeof(T));
+         result.resize(num_elements);
+         stream.read(result.data(), num_elements * sizeof(T));
+      } else {
+         result.resize(num_elements);
+         for (auto& x : result) from_bin(x, stream);
+      }
+      return result;
+   }
+
+ private:
+   input_stream elements;
+   uint32_t     num_elements = 0;
+};
+
+#define ALAIO_BIN_VIEW_MEMBER(STRUCT, FIELD)                                                                           \
+   auto FIELD() const { return this->template get<&STRUCT::FIELD>(); }
+
+/**
+ * ALAIO_BIN_VIEW(<struct>, <member>...)
+ * Declares <struct>_view, a bin_view<struct> with an accessor for each listed member, and makes it the view type used
+ * for <struct> wherever it is nested. Members of base classes may be listed. Declare the views of nested structs
+ * first.
+ */
+#define ALAIO_BIN_VIEW(STRUCT, ...)                                                                                    \
+   struct STRUCT##_view : ::alaio::bin_view<STRUCT> {                                                                  \
+      using ::alaio::bin_view<STRUCT>::bin_view;                                                                       \
+      ALAIO_MAP_REUSE_ARG0(ALAIO_BIN_VIEW_MEMBER, STRUCT, __VA_ARGS__)                                                 \
+   };                                                                                                                  \
+   STRUCT##_view bin_view_for(STRUCT*);
+
+} // namespace alaio
@@ -0,0 +1,390 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <vector>
+
+namespace alaio {
+
+/**
+ * Pool of small blocks grouped in size classes: multiples of 16 bytes up to 256, then powers of 2 up to
+ * max_class_size. Freed blocks are kept for later allocations of the same class; memory goes back to the system when
+ * the pool is destroyed. Larger blocks go straight to operator new.
+ */
+class slab_pool {
+ public:
+   static constexpr std::size_t chunk_size     = 1 << 20;
+   static constexpr std::size_t max_class_size = 1 << 14;
+
+   slab_pool() = default;
+   slab_pool(const slab_pool&) = delete;
+   slab_pool& operator=(const slab_pool&) = delete;
+
+   ~slab_pool() {
+      for (auto* c : chunks) ::operator delete(c);
+   }
+
+   void* allocate(std::size_t size) {
+      in_use += size;
+      auto cls = size_class(size);
+      if (cls == num_classes)
+         return ::operator new(size);
+      if (void* p = free_lists[cls]) {
+         free_lists[cls] = *static_cast<void**>(p);
+         return p;
+      }
+      auto bytes = class_size(cls);
+      if (chunk_remaining < bytes) {
+         chunk_pos       = static_cast<char*>(::operator new(chunk_size));
+         chunk_remaining = chunk_size;
+         chunks.push_back(chunk_pos);
+      }
+      void* p = chunk_pos;
+      chunk_pos += bytes;
+      chunk_remaining -= bytes;
+      return p;
+   }
+
+   void deallocate(void* p, std::size_t size) {
+      in_use -= size;
+      auto cls = size_class(size);
+      if (cls == num_classes)
+         return ::operator delete(p);
+      *static_cast<void**>(p) = free_lists[cls];
+      free_lists[cls]         = p;
+   }
+
+   // Bytes requested by live allocations
+   std::size_t get_in_use() const { return in_use; }
+
+ private:
+   static constexpr std::size_t num_classes = 22;
+
+   static std::size_t size_class(std::size_t size) {
+      if (size <= 256)
+         return size ? (size - 1) / 16 : 0;
+      if (size > max_class_size)
+         return num_classes;
+      std::size_t bits = 64 - __builtin_clzll(size - 1);
+      return 16 + bits - 9;
+   }
+
+   static std::size_t class_size(std::size_t cls) {
+      if (cls < 16)
+         return (cls + 1) * 16;
+      return std::size_t(1) << (cls - 16 + 9);
+   }
+
+   void*              free_lists[num_classes] = {};
+   char*              chunk_pos               = nullptr;
+   std::size_t        chunk_remaining         = 0;
+   std::size_t        in_use                  = 0;
+   std::vector<char*> chunks;
+};
+
+/**
+ * Ordered map from byte-string keys to byte-string values, kept in a B+-tree whose nodes and records come from a
+ * slab_pool. Each key and value is stored in a single record; leaves are linked for in-order scans.
+ */
+class bytes_btree {
+ public:
+   static constexpr int fanout = 64;
+
+   struct record {
+      uint32_t key_size;
+      uint32_t value_size;
+
+      std::string_view key() const { return { reinterpret_cast<const char*>(this + 1), key_size }; }
+      std::string_view value() const { return { reinterpret_cast<const char*>(this + 1) + key_size, value_size }; }
+   };
+
+ private:
+   struct node {
+      uint16_t size;
+      bool     leaf;
+   };
+
+   struct leaf_node : node {
+      record*    records[fanout];
+      leaf_node* prev;
+      leaf_node* next;
+   };
+
+   // keys[i] is a copy of the smallest key reachable from children[i + 1]
+   struct inner_node : node {
+      record* keys[fanout - 1];
+      node*   children[fanout];
+   };
+
+   struct path_entry {
+      inner_node* n;
+      int         child;
+   };
+
+   static constexpr int max_depth = 16;
+
+ public:
+   class iterator {
+    public:
+      iterator() = default;
+
+      const record& operator*() const { return *l->records[i]; }
+      const record* operator->() const { return l->records[i]; }
+
+      iterator& operator++() {
+         if (++i == l->size) {
+            l = l->next;
+            i = 0;
+         }
+         return *this;
+      }
+
+      friend bool operator==(const iterator& a, const iterator& b) { return a.l == b.l && a.i == b.i; }
+      friend bool operator!=(const iterator& a, const iterator& b) { return !(a == b); }
+
+    private:
+      friend bytes_btree;
+      iterator(const leaf_node* l, int i) : l(l), i(i) {
+         if (this->l && this->i == this->l->size) {
+            this->l = this->l->next;
+            this->i = 0;
+         }
+      }
+
+      const leaf_node* l = nullptr;
+      int              i = 0;
+   };
+
+   bytes_btree() { root = first_leaf = new_leaf(); }
+   bytes_btree(const bytes_btree&) = delete;
+   bytes_btree& operator=(const bytes_btree&) = delete;
+   ~bytes_btree() { destroy(root); }
+
+   std::size_t size() const { return count; }
+   bool        empty() const { return count == 0; }
+
+   // Bytes held by records and nodes
+   std::size_t memory_usage() const { return pool.get_in_use(); }
+
+   iterator begin() const { return { first_leaf, 0 }; }
+   iterator end() const { return {}; }
+
+   iterator lower_bound(std::string_view key) const {
+      path_entry p[max_depth];
+      auto*      l = find_leaf(key, p);
+      return { l, leaf_lower_bound(l, key) };
+   }
+
+   const record* find(std::string_view key) const {
+      path_entry p[max_depth];
+      auto*      l = find_leaf(key, p);
+      int        i = leaf_lower_bound(l, key);
+      if (i < l->size && l->records[i]->key() == key)
+         return l->records[i];
+      return nullptr;
+   }
+
+   // Inserts or replaces
+   void put(std::string_view key, std::string_view value) {
+      path_entry p[max_depth];
+      auto*      l = find_leaf(key, p);
+      int        i = leaf_lower_bound(l, key);
+      auto*      r = new_record(key, value);
+      if (i < l->size && l->records[i]->key() == key) {
+         free_record(l->records[i]);
+         l->records[i] = r;
+         return;
+      }
+      insert_record(l, i, r, p, height);
+      ++count;
+   }
+
+   // Returns false if key was not present
+   bool erase(std::string_view key) {
+      path_entry p[max_depth];
+      auto*      l = find_leaf(key, p);
+      int        i = leaf_lower_bound(l, key);
+      if (i == l->size || l->records[i]->key() != key)
+         return false;
+      free_record(l->records[i]);
+      std::copy(l->records + i + 1, l->records + l->size, l->records + i);
+      --l->size;
+      --count;
+      if (!l->size && l != root)
+         remove_leaf(l, p);
+      return true;
+   }
+
+ private:
+   slab_pool   pool;
+   node*       root       = nullptr;
+   leaf_node*  first_leaf = nullptr;
+   int         height     = 0; // number of inner levels
+   std::size_t count      = 0;
+
+   static int leaf_lower_bound(const leaf_node* l, std::string_view key) {
+      return std::lower_bound(l->records, l->records + l->size, key,
+                              [](const record* r, std::string_view k) { return r->key() < k; }) -
+             l->records;
+   }
+
+   leaf_node* find_leaf(std::string_view key, path_entry* p) const {
+      node* n = root;
+      for (int depth = 0; !n->leaf; ++depth) {
+         auto* in = static_cast<inner_node*>(n);
+         int   i  = std::upper_bound(in->keys, in->keys + in->size - 1, key,
+                                     [](std::string_view k, const record* r) { return k < r->key(); }) -
+                 in->keys;
+         p[depth] = { in, i };
+         n        = in->children[i];
+      }
+      return static_cast<leaf_node*>(n);
+   }
+
+   record* new_record(std::string_view key, std::string_view value) {
+      auto* r       = static_cast<record*>(pool.allocate(sizeof(record) + key.size() + value.size()));
+      r->key_size   = key.size();
+      r->value_size = value.size();
+      auto* data    = reinterpret_cast<char*>(r + 1);
+      memcpy(data, key.data(), key.size());
+      if (!value.empty())
+         memcpy(data + key.size(), value.data(), value.size());
+      return r;
+   }
+
+   void free_record(record* r) { pool.deallocate(r, sizeof(record) + r->key_size + r->value_size); }
+
+   leaf_node* new_leaf() {
+      auto* l = new (pool.allocate(sizeof(leaf_node))) leaf_node;
+      l->size = 0;
+      l->leaf = true;
+      l->prev = l->next = nullptr;
+      return l;
+   }
+
+   inner_node* new_inner() {
+      auto* in = new (pool.allocate(sizeof(inner_node))) inner_node;
+      in->size = 0;
+      in->leaf = false;
+      return in;
+   }
+
+   void free_node(node* n) {
+      if (n->leaf)
+         pool.deallocate(n, sizeof(leaf_node));
+      else
+         pool.deallocate(n, sizeof(inner_node));
+   }
+
+   void destroy(node* n) {
+      if (n->leaf) {
+         auto* l = static_cast<leaf_node*>(n);
+         for (int i = 0; i < l->size; ++i) free_record(l->records[i]);
+      } else {
+         auto* in = static_cast<inner_node*>(n);
+         for (int i = 0; i < in->size; ++i) destroy(in->children[i]);
+         for (int i = 0; i + 1 < in->size; ++i) free_record(in->keys[i]);
+      }
+      free_node(n);
+   }
+
+   void insert_record(leaf_node* l, int i, record* r, path_entry* p, int depth) {
+      if (l->size < fanout) {
+         std::copy_backward(l->records + i, l->records + l->size, l->records + l->size + 1);
+         l->records[i] = r;
+         ++l->size;
+         return;
+      }
+      constexpr int half  = fanout / 2;
+      auto*         right = new_leaf();
+      std::copy(l->records + half, l->records + fanout, right->records);
+      right->size = fanout - half;
+      l->size     = half;
+      right->prev = l;
+      right->next = l->next;
+      if (l->next)
+         l->next->prev = right;
+      l->next = right;
+      if (i <= half)
+         insert_record(l, i, r, p, depth);
+      else
+         insert_record(right, i - half, r, p, depth);
+      insert_child(p, depth, new_record(right->records[0]->key(), {}), right);
+   }
+
+   // Adds child, whose smallest key is sep, to the right of the node at depth
+   void insert_child(path_entry* p, int depth, record* sep, node* child) {
+      if (depth == 0) {
+         auto* r        = new_inner();
+         r->children[0] = root;
+         r->children[1] = child;
+         r->keys[0]     = sep;
+         r->size        = 2;
+         root           = r;
+         ++height;
+         return;
+      }
+      auto [in, i] = p[depth - 1];
+      if (in->size < fanout) {
+         std::copy_backward(in->keys + i, in->keys + in->size - 1, in->keys + in->size);
+         std::copy_backward(in->children + i + 1, in->children + in->size, in->children + in->size + 1);
+         in->keys[i]         = sep;
+         in->children[i + 1] = child;
+         ++in->size;
+         return;
+      }
+      record* keys[fanout];
+      node*   children[fanout + 1];
+      std::copy(in->keys, in->keys + i, keys);
+      keys[i] = sep;
+      std::copy(in->keys + i, in->keys + fanout - 1, keys + i + 1);
+      std::copy(in->children, in->children + i + 1, children);
+      children[i + 1] = child;
+      std::copy(in->children + i + 1, in->children + fanout, children + i + 2);
+
+      constexpr int left_children = (fanout + 1) / 2;
+      auto*         right         = new_inner();
+      in->size                    = left_children;
+      std::copy(children, children + left_children, in->children);
+      std::copy(keys, keys + left_children - 1, in->keys);
+      right->size = fanout + 1 - left_children;
+      std::copy(children + left_children, children + fanout + 1, right->children);
+      std::copy(keys + left_children, keys + fanout, right->keys);
+      insert_child(p, depth - 1, keys[left_children - 1], right);
+   }
+
+   void remove_leaf(leaf_node* l, path_entry* p) {
+      if (l->prev)
+         l->prev->next = l->next;
+      else
+         first_leaf = l->next;
+      if (l->next)
+         l->next->prev = l->prev;
+      free_node(l);
+      for (int depth = height - 1; depth >= 0; --depth) {
+         auto [in, i] = p[depth];
+         if (in->size > 1) {
+            // the separator left of the child, or right of it for the first child, goes with it
+            int k = i ? i - 1 : 0;
+            free_record(in->keys[k]);
+            std::copy(in->keys + k + 1, in->keys + in->size - 1, in->keys + k);
+            std::copy(in->children + i + 1, in->children + in->size, in->children + i);
+            --in->size;
+            break;
+         }
+         free_node(in);
+      }
+      while (!root->leaf && static_cast<inner_node*>(root)->size == 1) {
+         auto* old = static_cast<inner_node*>(root);
+         root      = old->children[0];
+         free_node(old);
+         --height;
+      }
+   }
+};
+
+} // namespace alaio
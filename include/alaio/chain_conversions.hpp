@@ -1,12 +1,20 @@
 #pragma once
 
+#include "number_format.hpp"
 #include "stream.hpp"
+#include <array>
 #include <chrono>
+#include <limits>
 #include <stdint.h>
 #include <string>
 #include <string_view>
 #include <vector>
 #include <optional>
+#include <utility>
+
+#ifdef __BMI2__
+#   include <immintrin.h>
+#endif
 
 namespace alaio {
 
@@ -100,15 +108,27 @@ inline constexpr uint64_t char_to_name_digit(char c) {
    return 0;
 }
 
+// char_to_name_digit for every byte
+inline constexpr auto name_digit_table = [] {
+   std::array<uint8_t, 256> result{};
+   for (int c = 0; c < 256; ++c) result[c] = char_to_name_digit(char(c));
+   return result;
+}();
+
 inline constexpr uint64_t string_to_name(const char* str, int size) {
    uint64_t name = 0;
    int      i    = 0;
-   for (; i < size && i < 12; ++i) name |= (char_to_name_digit(str[i]) & 0x1f) << (64 - 5 * (i + 1));
+   for (; i < size && i < 12; ++i) name |= uint64_t(name_digit_table[uint8_t(str[i])]) << (64 - 5 * (i + 1));
    if (i < size)
-      name |= char_to_name_digit(str[i]) & 0x0F;
+      name |= name_digit_table[uint8_t(str[i])] & 0x0F;
    return name;
 }
 
+// string_to_name for count strings
+inline void string_to_names(const std::string_view* strs, std::size_t count, uint64_t* names) {
+   for (std::size_t i = 0; i < count; ++i) names[i] = string_to_name(strs[i].data(), strs[i].size());
+}
+
 inline constexpr uint64_t string_to_name(const char* str) {
    int len = 0;
    while (str[len]) ++len;
@@ -213,92 +233,111 @@ constexpr inline uint64_t string_to_name_strict(std::string_view str) {
    __builtin_unreachable();
 }
 
-inline std::string name_to_string(uint64_t name) {
-   static const char* charmap = ".12345abcdefghijklmnopqrstuvwxyz";
-   std::string        str(13, '.');
-
-   uint64_t tmp = name;
-   for (uint32_t i = 0; i <= 12; ++i) {
-      char c      = charmap[tmp & (i == 0 ? 0x0f : 0x1f)];
-      str[12 - i] = c;
-      tmp >>= (i == 0 ? 4 : 5);
-   }
+// Maps 8 name digits, one per byte, to their characters: 0 -> '.', 1-5 -> '1'-'5', 6-31 -> 'a'-'z'
+inline uint64_t name_digits_to_chars(uint64_t digits) {
+   constexpr uint64_t ones = 0x0101010101010101;
+   uint64_t           zero   = ((0x80 * ones - digits) & (0x80 * ones)) >> 7;
+   uint64_t           letter = ((digits + (0x80 - 6) * ones) & (0x80 * ones)) >> 7;
+   return digits + '0' * ones + ('a' - 6 - '0') * letter - ('0' - '.') * zero;
+}
 
-   const auto last = str.find_last_not_of('.');
-   return str.substr(0, last + 1);
+// Writes the characters of a name, without trailing dots, to dest and returns the end. dest must have room for 13
+// characters even when the name is shorter.
+inline char* name_to_chars(uint64_t name, char* dest) {
+   // one digit per byte, first digit in the lowest byte
+#ifdef __BMI2__
+   uint64_t first8 = __builtin_bswap64(_pdep_u64(name >> 24, 0x1f1f1f1f1f1f1f1f));
+   uint32_t next4  = __builtin_bswap32(uint32_t(_pdep_u64((name >> 4) & 0xfffff, 0x1f1f1f1f)));
+#else
+   uint64_t first8 = 0;
+   uint32_t next4  = 0;
+   for (int i = 0; i < 8; ++i) first8 |= ((name >> (59 - 5 * i)) & 0x1f) << (8 * i);
+   for (int i = 0; i < 4; ++i) next4 |= uint32_t((name >> (19 - 5 * i)) & 0x1f) << (8 * i);
+#endif
+   uint64_t chars8 = name_digits_to_chars(first8);
+   uint32_t chars4 = uint32_t(name_digits_to_chars(next4));
+   memcpy(dest, &chars8, 8);
+   memcpy(dest + 8, &chars4, 4);
+   dest[12] = ".12345abcdefghij"[name & 0xf];
+   if (!name)
+      return dest;
+   int low_bit = __builtin_ctzll(name);
+   return dest + (low_bit < 4 ? 13 : (63 - low_bit) / 5 + 1);
 }
 
-inline std::string microseconds_to_str(uint64_t microseconds) {
-   std::string result;
-
-   auto append_uint = [&result](uint32_t value, int digits) {
-      char  s[20];
-      char* ch = s;
-      while (digits--) {
-         *ch++ = '0' + (value % 10);
-         value /= 10;
-      };
-      std::reverse(s, ch);
-      result.insert(result.end(), s, ch);
+inline std::string name_to_string(uint64_t name) {
+   char buf[13];
+   return std::string(buf, name_to_chars(name, buf));
+}
+
+// Length of a time written by microseconds_to_chars: YYYY-MM-DDTHH:MM:SS.mmm
+inline constexpr int utc_time_size = 23;
+
+// Writes a time as YYYY-MM-DDTHH:MM:SS.mmm to dest and returns the end. Consecutive times usually fall on the same
+// day, so each thread keeps the last date it wrote.
+inline char* microseconds_to_chars(uint64_t microseconds, char* dest) {
+   struct date_cache {
+      int  day = std::numeric_limits<int>::min();
+      char date[11];
    };
+   thread_local date_cache cache;
 
    std::chrono::microseconds us{ microseconds };
    sys_days                  sd(std::chrono::floor<days>(us));
-   auto                      ymd = year_month_day{ sd };
-   uint32_t                  ms  = (std::chrono::floor<std::chrono::milliseconds>(us) - sd.time_since_epoch()).count();
-   us -= sd.time_since_epoch();
-   append_uint((int)ymd.year(), 4);
-   result.push_back('-');
-   append_uint((unsigned)ymd.month(), 2);
-   result.push_back('-');
-   append_uint((unsigned)ymd.day(), 2);
-   result.push_back('T');
-   append_uint(ms / 3600000 % 60, 2);
-   result.push_back(':');
-   append_uint(ms / 60000 % 60, 2);
-   result.push_back(':');
-   append_uint(ms / 1000 % 60, 2);
-   result.push_back('.');
-   append_uint(ms % 1000, 3);
-   return result;
+   if (sd.time_since_epoch().count() != cache.day) {
+      auto ymd = year_month_day{ sd };
+      write_decimal_digits(ymd.year(), cache.date + 4, 4);
+      cache.date[4] = '-';
+      write_decimal_digits(ymd.month(), cache.date + 7, 2);
+      cache.date[7] = '-';
+      write_decimal_digits(ymd.day(), cache.date + 10, 2);
+      cache.date[10] = 'T';
+      cache.day      = sd.time_since_epoch().count();
+   }
+   uint32_t ms = (std::chrono::floor<std::chrono::milliseconds>(us) - sd.time_since_epoch()).count();
+   memcpy(dest, cache.date, sizeof(cache.date));
+   write_decimal_digits(ms / 3600000, dest + 13, 2);
+   dest[13] = ':';
+   write_decimal_digits(ms / 60000 % 60, dest + 16, 2);
+   dest[16] = ':';
+   write_decimal_digits(ms / 1000 % 60, dest + 19, 2);
+   dest[19] = '.';
+   write_decimal_digits(ms % 1000, dest + 23, 3);
+   return dest + utc_time_size;
+}
+
+inline std::string microseconds_to_str(uint64_t microseconds) {
+   char buf[utc_time_size];
+   return std::string(buf, microseconds_to_chars(microseconds, buf));
 }
 
+// True if the 8 bytes at p match pattern, where '0' in pattern stands for any decimal digit; assumes a little-endian
+// host
+inline bool matches_digit_pattern(const char* p, const char (&pattern)[9]) {
+   uint64_t v, t, limit = 0;
+   memcpy(&v, p, sizeof(v));
+   memcpy(&t, pattern, sizeof(t));
+   for (int i = 0; i < 8; ++i) limit |= uint64_t(pattern[i] == '0' ? 0x76 : 0x7f) << (8 * i);
+   // digits become 0-9 and separators 0; adding limit sets the top bit of any byte outside that range
+   uint64_t x = v ^ t;
+   return !(((x + limit) | x) & 0x8080808080808080);
+}
+
+// Parses the fixed layout YYYY-MM-DDTHH:MM:SS, checking it with three overlapping 8-byte loads
 [[nodiscard]] inline bool string_to_utc_seconds(uint32_t& result, const char*& s, const char* end, bool eat_fractional,
                                                 bool require_end) {
-   auto parse_uint = [&](uint32_t& result, int digits) {
-      result = 0;
-      while (digits--) {
-         if (s != end && *s >= '0' && *s <= '9')
-            result = result * 10 + *s++ - '0';
-         else
-            return false;
-      }
-      return true;
-   };
-   uint32_t y, m, d, h, min, sec;
-   if (!parse_uint(y, 4))
-      return false;
-   if (s == end || *s++ != '-')
-      return false;
-   if (!parse_uint(m, 2))
-      return false;
-   if (s == end || *s++ != '-')
-      return false;
-   if (!parse_uint(d, 2))
+   if (end - s < 19 || !matches_digit_pattern(s, "0000-00-") || !matches_digit_pattern(s + 8, "00T00:00") ||
+       !matches_digit_pattern(s + 11, "00:00:00"))
       return false;
-   if (s == end || *s++ != 'T')
-      return false;
-   if (!parse_uint(h, 2))
-      return false;
-   if (s == end || *s++ != ':')
-      return false;
-   if (!parse_uint(min, 2))
-      return false;
-   if (s == end || *s++ != ':')
-      return false;
-   if (!parse_uint(sec, 2))
-      return false;
-   result = sys_days(year_month_day{year_t{y}, month_t{m}, day_t{d}}.to_days()).time_since_epoch().count() * 86400 + h * 3600 + min * 60 + sec;
+   auto digits = [&](int pos, int n) {
+      uint32_t value = 0;
+      for (int i = 0; i < n; ++i) value = value * 10 + (s[pos + i] - '0');
+      return value;
+   };
+   uint32_t y = digits(0, 4), m = digits(5, 2), d = digits(8, 2);
+   result = sys_days(year_month_day{year_t{y}, month_t{m}, day_t{d}}.to_days()).time_since_epoch().count() * 86400 +
+            digits(11, 2) * 3600 + digits(14, 2) * 60 + digits(17, 2);
+   s += 19;
    if (eat_fractional && s != end && *s == '.') {
       ++s;
       while (s != end && *s >= '0' && *s <= '9') ++s;
@@ -349,13 +388,23 @@ inline std::string microseconds_to_str(uint64_t microseconds) {
    return string_to_symbol_code(result, pos, end, true);
 }
 
+// Writes the characters of a symbol code to dest, which must have room for 8, and returns the end
+inline char* symbol_code_to_chars(uint64_t v, char* dest) {
+   // the characters are the significant bytes of v, lowest first; assumes a little-endian host
+   memcpy(dest, &v, sizeof(v));
+   return v ? dest + (71 - __builtin_clzll(v)) / 8 : dest;
+}
+
 inline std::string symbol_code_to_string(uint64_t v) {
-   std::string result;
-   while (v > 0) {
-      result += char(v & 0xFF);
-      v >>= 8;
-   }
-   return result;
+   char buf[8];
+   return std::string(buf, symbol_code_to_chars(v, buf));
+}
+
+// Writes a symbol as "precision,code" to dest, which must have room for 12, and returns the end
+inline char* symbol_to_chars(uint64_t v, char* dest) {
+   dest    = uint64_to_decimal(v & 0xff, dest);
+   *dest++ = ',';
+   return symbol_code_to_chars(v >> 8, dest);
 }
 
 [[nodiscard]] inline bool string_to_symbol(uint64_t& result, uint8_t precision, const char*& pos, const char* end,
@@ -384,33 +433,32 @@ inline std::string symbol_code_to_string(uint64_t v) {
 }
 
 inline std::string symbol_to_string(uint64_t v) {
-   return std::to_string(v & 0xff) + "," + alaio::symbol_code_to_string(v >> 8);
+   char buf[12];
+   return std::string(buf, symbol_to_chars(v, buf));
 }
 
 [[nodiscard]] inline bool string_to_asset(int64_t& amount, uint64_t& symbol, const char*& s, const char* end,
                                           bool expect_end) {
-   // todo: check overflow
    while (s != end && *s == ' ') //
       ++s;
    uint64_t uamount   = 0;
-   uint8_t  precision = 0;
+   int      precision = 0;
    bool     negative  = false;
    if (s != end && *s == '-') {
       ++s;
       negative = true;
    }
-   while (s != end && *s >= '0' && *s <= '9') //
-      uamount = uamount * 10 + (*s++ - '0');
+   if (append_decimal_digits(uamount, s, end) < 0)
+      return false;
    if (s != end && *s == '.') {
       ++s;
-      while (s != end && *s >= '0' && *s <= '9') {
-         uamount = uamount * 10 + (*s++ - '0');
-         ++precision;
-      }
+      precision = append_decimal_digits(uamount, s, end);
+      if (precision < 0 || precision > 0xff)
+         return false;
    }
-   if (negative)
-      uamount = -uamount;
-   amount = uamount;
+   if (uamount > uint64_t(std::numeric_limits<int64_t>::max()) + negative)
+      return false;
+   amount = negative ? int64_t(0 - uamount) : int64_t(uamount);
    uint64_t code;
    if (!alaio::string_to_symbol_code(code, s, end, expect_end))
       return false;
@@ -422,29 +470,51 @@ inline std::string symbol_to_string(uint64_t v) {
    return string_to_asset(amount, symbol, s, end, true);
 }
 
-inline std::string asset_to_string(int64_t amount, uint64_t symbol) {
-   std::string result;
-   uint64_t    uamount;
+// Room needed by asset_to_chars: sign, "0.", 255 digits of precision, space and 8 bytes for the symbol code
+inline constexpr int asset_max_size = 1 + 2 + 255 + 1 + 8;
+
+template <int Precision>
+char* fixed_point_to_chars(uint64_t value, char* dest) {
+   constexpr uint64_t scale = [] {
+      uint64_t result = 1;
+      for (int i = 0; i < Precision; ++i) result *= 10;
+      return result;
+   }();
+   dest    = uint64_to_decimal(value / scale, dest);
+   *dest++ = '.';
+   write_decimal_digits(value % scale, dest + Precision, Precision);
+   return dest + Precision;
+}
+
+// Dispatches to a fixed_point_to_chars with a constant divisor for precisions which leave an integer part
+template <int... Precisions>
+char* fixed_point_to_chars(uint64_t value, int precision, char* dest, std::integer_sequence<int, Precisions...>) {
+   ((precision == Precisions + 1 && (dest = fixed_point_to_chars<Precisions + 1>(value, dest))) || ...);
+   return dest;
+}
+
+// Writes an asset, e.g. "-1.2345 ALA", to dest and returns the end
+inline char* asset_to_chars(int64_t amount, uint64_t symbol, char* dest) {
+   uint64_t uamount   = amount < 0 ? 0 - uint64_t(amount) : amount;
+   int      precision = symbol & 0xff;
    if (amount < 0)
-      uamount = -amount;
-   else
-      uamount = amount;
-   uint8_t precision = symbol;
-   if (precision) {
-      while (precision--) {
-         result += '0' + uamount % 10;
-         uamount /= 10;
-      }
-      result += '.';
+      *dest++ = '-';
+   if (precision == 0)
+      dest = uint64_to_decimal(uamount, dest);
+   else if (precision < 20)
+      dest = fixed_point_to_chars(uamount, precision, dest, std::make_integer_sequence<int, 19>{});
+   else {
+      memcpy(dest, "0.", 2);
+      write_decimal_digits(uamount, dest + 2 + precision, precision);
+      dest += 2 + precision;
    }
-   do {
-      result += '0' + uamount % 10;
-      uamount /= 10;
-   } while (uamount);
-   if (amount < 0)
-      result += '-';
-   std::reverse(result.begin(), result.end());
-   return result + ' ' + alaio::symbol_code_to_string(symbol >> 8);
+   *dest++ = ' ';
+   return symbol_code_to_chars(symbol >> 8, dest);
+}
+
+inline std::string asset_to_string(int64_t amount, uint64_t symbol) {
+   char buf[asset_max_size];
+   return std::string(buf, asset_to_chars(amount, symbol, buf));
 }
 
 } // namespace alaio
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "bytes_btree.hpp"
+#include "ship_protocol.hpp"
+#include "to_key.hpp"
+#include "undo_log.hpp"
+
+#include <optional>
+#include <string_view>
+
+namespace alaio {
+
+/**
+ * In-memory copy of contract tables, rows and secondary indexes, maintained from state-history table deltas.
+ *
+ * Everything lives in one ordered map whose keys are `to_key` encodings, so related entries are adjacent:
+ *    table:       (code, scope, table, kind::table)                              -> payer
+ *    row:         (code, scope, table, kind::row, primary_key)                   -> payer, value
+ *    index entry: (code, scope, table, kind::index*, secondary_key, primary_key) -> payer
+ *
+ * Changes applied through apply(const get_blocks_result_v0&) are recorded until their block becomes irreversible, so
+ * that a fork can be rolled back.
+ */
+class chain_state {
+ public:
+   enum class kind : uint8_t { table, row, index64, index128, index256, index_double, index_long_double };
+
+   // Holds an encoded key; the largest is an index256 entry
+   struct key {
+      char        data[72];
+      std::size_t size = 0;
+
+      operator std::string_view() const { return { data, size }; }
+   };
+
+   struct row_view {
+      name         payer;
+      input_stream value;
+   };
+
+   // Encodes a key, or a key prefix for scan
+   template <typename... Ts>
+   static key make_key(const Ts&... parts) {
+      key              result;
+      fixed_buf_stream stream{ result.data, sizeof(result.data) };
+      (to_key(parts, stream), ...);
+      result.size = stream.pos - result.data;
+      return result;
+   }
+
+   static key table_key(name code, name scope, name table) { return make_key(code, scope, table, kind::table); }
+
+   static key row_key(name code, name scope, name table, uint64_t primary_key) {
+      return make_key(code, scope, table, kind::row, primary_key);
+   }
+
+   // Applies a block's deltas. Blocks at or above this_block which were already applied are first rolled back, and
+   // undo data for blocks up to last_irreversible is discarded afterwards.
+   void apply(const ship_protocol::get_blocks_result_v0& result) {
+      check(result.this_block.has_value(), "get_blocks_result_v0 has no this_block");
+      auto block_num = result.this_block->block_num;
+      undo.revert(entries, block_num);
+      if (block_num > result.last_irreversible.block_num)
+         undo.start_block(block_num);
+      if (result.deltas)
+         apply(*result.deltas);
+      undo.commit(result.last_irreversible.block_num);
+   }
+
+   // Rolls back every recorded block >= block_num
+   void revert(uint32_t block_num) { undo.revert(entries, block_num); }
+
+   const undo_log& get_undo_log() const { return undo; }
+
+   // Applies one table delta. Deltas for tables other than contract_table, contract_row and contract_index* are
+   // ignored.
+   void apply(const ship_protocol::table_delta_v0& delta) {
+      if (delta.name == "contract_table")
+         apply_rows<ship_protocol::contract_table>(delta);
+      else if (delta.name == "contract_row")
+         apply_rows<ship_protocol::contract_row>(delta);
+      else if (delta.name == "contract_index64")
+         apply_rows<ship_protocol::contract_index64>(delta);
+      else if (delta.name == "contract_index128")
+         apply_rows<ship_protocol::contract_index128>(delta);
+      else if (delta.name == "contract_index256")
+         apply_rows<ship_protocol::contract_index256>(delta);
+      else if (delta.name == "contract_index_double")
+         apply_rows<ship_protocol::contract_index_double>(delta);
+      else if (delta.name == "contract_index_long_double")
+         apply_rows<ship_protocol::contract_index_long_double>(delta);
+   }
+
+   // Applies serialized std::vector<table_delta>, e.g. get_blocks_result_v0::deltas
+   void apply(input_stream deltas) {
+      uint32_t size;
+      varuint32_from_bin(size, deltas);
+      for (uint32_t i = 0; i < size; ++i) {
+         ship_protocol::table_delta delta;
+         from_bin(delta, deltas);
+         apply(std::get<ship_protocol::table_delta_v0>(delta));
+      }
+   }
+
+   std::optional<std::string_view> get(std::string_view k) const {
+      if (auto* r = entries.find(k))
+         return r->value();
+      return {};
+   }
+
+   std::optional<name> get_table(name code, name scope, name table) const {
+      auto v = get(table_key(code, scope, table));
+      if (!v)
+         return {};
+      return read_payer(*v);
+   }
+
+   std::optional<row_view> get_row(name code, name scope, name table, uint64_t primary_key) const {
+      auto v = get(row_key(code, scope, table, primary_key));
+      if (!v)
+         return {};
+      return row_view{ read_payer(*v), input_stream{ v->data() + sizeof(uint64_t), v->size() - sizeof(uint64_t) } };
+   }
+
+   // Calls f(std::string_view key, std::string_view value) in key order for every entry whose key starts with prefix
+   // until f returns false
+   template <typename F>
+   void scan(std::string_view prefix, F&& f) const {
+      for (auto it = entries.lower_bound(prefix); it != entries.end(); ++it) {
+         auto k = it->key();
+         if (k.substr(0, prefix.size()) != prefix || !f(k, it->value()))
+            break;
+      }
+   }
+
+   // Calls f(uint64_t primary_key, const row_view&) for every row of a table in primary key order until f returns
+   // false
+   template <typename F>
+   void scan_rows(name code, name scope, name table, F&& f) const {
+      auto prefix = make_key(code, scope, table, kind::row);
+      scan(prefix, [&](std::string_view k, std::string_view v) {
+         uint64_t primary_key = 0;
+         for (auto c : k.substr(prefix.size)) primary_key = (primary_key << 8) | uint8_t(c);
+         return f(primary_key, row_view{ read_payer(v), input_stream{ v.data() + sizeof(uint64_t),
+                                                                      v.size() - sizeof(uint64_t) } });
+      });
+   }
+
+   std::size_t size() const { return entries.size(); }
+   std::size_t memory_usage() const { return entries.memory_usage(); }
+
+ private:
+   bytes_btree entries;
+   undo_log    undo;
+
+   static name read_payer(std::string_view v) {
+      uint64_t payer;
+      memcpy(&payer, v.data(), sizeof(payer));
+      return name{ payer };
+   }
+
+   template <typename T>
+   void apply_rows(const ship_protocol::table_delta_v0& delta) {
+      for (auto& row : delta.rows) {
+         T    obj;
+         auto stream = row.data;
+         from_bin(obj, stream);
+         std::visit([&](auto& o) { apply_row(o, row.present); }, obj);
+      }
+   }
+
+   void put_or_erase(const key& k, bool present, const char* value, std::size_t size) {
+      undo.record(entries, k);
+      if (present)
+         entries.put(k, { value, size });
+      else
+         entries.erase(k);
+   }
+
+   void apply_row(const ship_protocol::contract_table_v0& obj, bool present) {
+      put_or_erase(table_key(obj.code, obj.scope, obj.table), present, reinterpret_cast<const char*>(&obj.payer),
+                   sizeof(obj.payer));
+   }
+
+   void apply_row(const ship_protocol::contract_row_v0& obj, bool present) {
+      auto k = row_key(obj.code, obj.scope, obj.table, obj.primary_key);
+      undo.record(entries, k);
+      if (!present)
+         return (void)entries.erase(k);
+      // payer and value share one record
+      std::size_t       size = sizeof(uint64_t) + obj.value.remaining();
+      small_buffer<256> small;
+      std::vector<char> large;
+      char*             buf = small.data;
+      if (size > sizeof(small.data)) {
+         large.resize(size);
+         buf = large.data();
+      }
+      memcpy(buf, &obj.payer, sizeof(uint64_t));
+      memcpy(buf + sizeof(uint64_t), obj.value.pos, obj.value.remaining());
+      entries.put(k, { buf, size });
+   }
+
+   template <typename T>
+   void apply_index(const T& obj, kind k, bool present) {
+      put_or_erase(make_key(obj.code, obj.scope, obj.table, k, obj.secondary_key, obj.primary_key), present,
+                   reinterpret_cast<const char*>(&obj.payer), sizeof(obj.payer));
+   }
+
+   void apply_row(const ship_protocol::contract_index64_v0& obj, bool present) {
+      apply_index(obj, kind::index64, present);
+   }
+   void apply_row(const ship_protocol::contract_index128_v0& obj, bool present) {
+      apply_index(obj, kind::index128, present);
+   }
+   void apply_row(const ship_protocol::contract_index256_v0& obj, bool present) {
+      apply_index(obj, kind::index256, present);
+   }
+   void apply_row(const ship_protocol::contract_index_double_v0& obj, bool present) {
+      apply_index(obj, kind::index_double, present);
+   }
+   void apply_row(const ship_protocol::contract_index_long_double_v0& obj, bool present) {
+      apply_index(obj, kind::index_long_double, present);
+   }
+};
+
+} // namespace alaio
@@ -27,10 +27,6 @@ struct widening_conversion {
 };
 
 no_conversion conversion_kind(...);
-void          serialize_as(...);
-
-template <typename T>
-using serialization_type = decltype(serialize_as(std::declval<T>()));
 
 template <typename T, typename U>
 using conversion_kind_t =
@@ -7,6 +7,8 @@
 #include <variant>
 #include <vector>
 #include <array>
+#include <memory>
+#include <string_view>
 
 namespace alaio {
 
@@ -116,14 +118,53 @@ private_key private_key_from_string(std::string_view s);
 std::string signature_to_string(const signature& obj);
 signature   signature_from_string(std::string_view s);
 
+// Same results as public_key_to_string and signature_to_string; the checksums are hashed several at a time
+std::vector<std::string> public_keys_to_string(const std::vector<public_key>& keys);
+std::vector<std::string> signatures_to_string(const std::vector<signature>& signatures);
+
+/**
+ * Bounded, thread-safe memo of public key conversions in both directions, keyed on the serialized key and on the
+ * string. Entries are spread over shards, each with its own mutex; a full shard evicts one entry, chosen at random,
+ * for each insert.
+ * Install one with set_key_string_cache() to have to_json and from_json of public_key use it.
+ */
+class key_string_cache {
+ public:
+   explicit key_string_cache(std::size_t capacity = 64 * 1024);
+   ~key_string_cache();
+
+   std::string to_string(const public_key& key);
+   public_key  from_string(std::string_view s);
+
+   uint64_t hits() const;
+   uint64_t misses() const;
+
+ private:
+   struct shard;
+   static constexpr std::size_t num_shards = 16;
+
+   std::size_t              shard_capacity;
+   std::unique_ptr<shard[]> shards;
+};
+
+// The cache used by to_json and from_json of public_key, or nullptr (the default) for none. The cache must outlive
+// its use.
+void              set_key_string_cache(key_string_cache* cache);
+key_string_cache* get_key_string_cache();
+
 template <typename S>
 void to_json(const public_key& obj, S& stream) {
+   if (auto* cache = get_key_string_cache())
+      return to_json(cache->to_string(obj), stream);
    to_json(public_key_to_string(obj), stream);
 }
 template <typename S>
 void from_json(public_key& obj, S& stream) {
    auto s = stream.get_string();
-   obj = public_key_from_string(s);
+   if (auto* cache = get_key_string_cache())
+      obj = cache->from_string(s);
+   else
+      obj = public_key_from_string(s);
 }
 template <typename S>
 void to_json(const private_key& obj, S& stream) {
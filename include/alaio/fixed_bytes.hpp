@@ -214,6 +214,12 @@ ALAIO_REFLECT(checksum160, value);
 ALAIO_REFLECT(checksum256, value);
 ALAIO_REFLECT(checksum512, value);
 
+// Words are stored in host order, but serialized as bytes
+template <typename T, std::size_t Size>
+constexpr bool has_custom_serialization(fixed_bytes<Size, T>*) {
+   return true;
+}
+
 template <typename T, std::size_t Size, typename S>
 void from_bin(fixed_bytes<Size, T>& obj, S& stream) {
    std::array<std::uint8_t, Size> bytes;
@@ -221,6 +227,11 @@ void from_bin(fixed_bytes<Size, T>& obj, S& stream) {
    obj = fixed_bytes<Size, T>(bytes);
 }
 
+template <typename T, std::size_t Size, typename S>
+void skip_bin(fixed_bytes<Size, T>*, S& stream) {
+   stream.skip(Size);
+}
+
 template <typename T, std::size_t Size, typename S>
 void to_bin(const fixed_bytes<Size, T>& obj, S& stream) {
    to_bin(obj.extract_as_byte_array(), stream);
@@ -13,13 +13,51 @@
 #include <vector>
 #include <string_view>
 
+#ifdef __BMI2__
+#   include <immintrin.h>
+#endif
+
 namespace alaio {
 
 template <typename T, typename S>
 void from_bin(T& obj, S& stream);
 
+template <typename T, typename S>
+void skip_bin(T*, S& stream);
+
+// Decodes the varuint at the start of the 8 bytes at p if it ends within them: stores its value, which has at most 56
+// bits, and returns its length. Returns 0 otherwise. Assumes a little-endian host.
+inline int varuint_from_word(uint64_t& dest, const char* p) {
+   uint64_t word;
+   memcpy(&word, p, sizeof(word));
+   uint64_t stops = ~word & 0x8080'8080'8080'8080;
+   if (!stops)
+      return 0;
+   int len = __builtin_ctzll(stops) / 8 + 1;
+   if (len < 8)
+      word &= (uint64_t(1) << (len * 8)) - 1;
+#ifdef __BMI2__
+   dest = _pext_u64(word, 0x7f7f'7f7f'7f7f'7f7f);
+#else
+   word &= 0x7f7f'7f7f'7f7f'7f7f;
+   word = (word & 0x007f'007f'007f'007f) | ((word & 0x7f00'7f00'7f00'7f00) >> 1);
+   word = (word & 0x0000'3fff'0000'3fff) | ((word & 0x3fff'0000'3fff'0000) >> 2);
+   dest = (word & 0x0000'0000'0fff'ffff) | ((word & 0x0fff'ffff'0000'0000) >> 4);
+#endif
+   return len;
+}
+
 template <typename S>
 void varuint32_from_bin(uint32_t& dest, S& stream) {
+   if constexpr (std::is_convertible_v<S&, input_stream&>) {
+      uint64_t value;
+      int      len;
+      if (stream.end - stream.pos >= 8 && (len = varuint_from_word(value, stream.pos)) && len <= 5) {
+         dest = uint32_t(value);
+         stream.pos += len;
+         return;
+      }
+   }
    dest          = 0;
    int     shift = 0;
    uint8_t b     = 0;
@@ -33,6 +71,14 @@ void varuint32_from_bin(uint32_t& dest, S& stream) {
 
 template <typename S>
 void varuint64_from_bin(uint64_t& dest, S& stream) {
+   if constexpr (std::is_convertible_v<S&, input_stream&>) {
+      if (stream.end - stream.pos >= 8) {
+         if (int len = varuint_from_word(dest, stream.pos)) {
+            stream.pos += len;
+            return;
+         }
+      }
+   }
    dest          = 0;
    int     shift = 0;
    uint8_t b     = 0;
@@ -44,6 +90,35 @@ void varuint64_from_bin(uint64_t& dest, S& stream) {
    } while (b & 0x80);
 }
 
+// Decodes count varuint32s to dest. Single-byte values, the common case for sizes and ordinals, are located with one
+// mask over 8 bytes and widened together.
+template <typename It, typename S>
+void varuint32s_from_bin(It dest, std::size_t count, S& stream) {
+   if constexpr (std::is_convertible_v<S&, input_stream&>) {
+      while (count && stream.end - stream.pos >= 8) {
+         uint64_t word;
+         memcpy(&word, stream.pos, sizeof(word));
+         uint64_t    continues = word & 0x8080'8080'8080'8080;
+         std::size_t n         = std::min<std::size_t>(continues ? __builtin_ctzll(continues) / 8 : 8, count);
+         if (!n) {
+            uint32_t value;
+            varuint32_from_bin(value, stream);
+            *dest++ = value;
+            --count;
+            continue;
+         }
+         for (std::size_t i = 0; i < n; ++i) *dest++ = uint32_t(uint8_t(stream.pos[i]));
+         stream.pos += n;
+         count -= n;
+      }
+   }
+   for (; count; --count) {
+      uint32_t value;
+      varuint32_from_bin(value, stream);
+      *dest++ = value;
+   }
+}
+
 template <typename S>
 void varint32_from_bin(int32_t& result, S& stream) {
    uint32_t v;
@@ -89,8 +164,8 @@ void from_bin(T (&v)[N], S& stream) {
    }
 }
 
-template <typename T, typename S>
-void from_bin(std::vector<T>& v, S& stream) {
+template <typename T, typename A, typename S>
+void from_bin(std::vector<T, A>& v, S& stream) {
    if constexpr (has_bitwise_serialization<T>()) {
       if constexpr (sizeof(size_t) >= 8) {
          uint64_t size;
@@ -172,6 +247,14 @@ inline void from_bin(std::string& obj, S& stream) {
    stream.read(obj.data(), obj.size());
 }
 
+template <typename A, typename S>
+void from_bin(std::basic_string<char, std::char_traits<char>, A>& obj, S& stream) {
+   uint32_t size;
+   varuint32_from_bin(size, stream);
+   obj.resize(size);
+   stream.read(obj.data(), obj.size());
+}
+
 template <typename S>
 inline void from_bin(std::string_view& obj, S& stream) {
    uint32_t size;
@@ -256,6 +339,105 @@ T from_bin(S& stream) {
    return obj;
 }
 
+// skip_bin((T*)nullptr, stream) advances stream past a serialized T without decoding it. Types without a cheaper
+// rule are decoded into a temporary.
+
+template <typename T, typename S>
+void skip_bin(std::vector<T>*, S& stream) {
+   if constexpr (has_bitwise_serialization<T>()) {
+      uint64_t size;
+      varuint64_from_bin(size, stream);
+      check( size <= stream.remaining() / sizeof(T), convert_stream_error(stream_error::overrun) );
+      stream.skip(size * sizeof(T));
+   } else {
+      uint32_t size;
+      varuint32_from_bin(size, stream);
+      for (size_t i = 0; i < size; ++i) {
+         skip_bin((T*)nullptr, stream);
+      }
+   }
+}
+
+template <typename S>
+void skip_bin(input_stream*, S& stream) {
+   uint64_t size;
+   varuint64_from_bin(size, stream);
+   stream.skip(size);
+}
+
+template <typename S>
+void skip_bin(std::string*, S& stream) {
+   uint32_t size;
+   varuint32_from_bin(size, stream);
+   stream.skip(size);
+}
+
+template <typename S>
+void skip_bin(std::string_view*, S& stream) {
+   skip_bin((std::string*)nullptr, stream);
+}
+
+template <typename T, typename S>
+void skip_bin(std::optional<T>*, S& stream) {
+   bool present;
+   from_bin(present, stream);
+   if (present)
+      skip_bin((T*)nullptr, stream);
+}
+
+template <uint32_t I, typename... Ts, typename S>
+void variant_skip_bin(uint32_t i, S& stream) {
+   if constexpr (I < sizeof...(Ts)) {
+      if (i == I)
+         skip_bin((std::variant_alternative_t<I, std::variant<Ts...>>*)nullptr, stream);
+      else
+         variant_skip_bin<I + 1, Ts...>(i, stream);
+   } else {
+      check( false, convert_stream_error(stream_error::bad_variant_index) );
+   }
+}
+
+template <typename... Ts, typename S>
+void skip_bin(std::variant<Ts...>*, S& stream) {
+   uint32_t u;
+   varuint32_from_bin(u, stream);
+   variant_skip_bin<0, Ts...>(u, stream);
+}
+
+template <typename T, std::size_t N, typename S>
+void skip_bin(std::array<T, N>*, S& stream) {
+   if constexpr (has_bitwise_serialization<T>()) {
+      stream.skip(N * sizeof(T));
+   } else {
+      for (size_t i = 0; i < N; ++i) {
+         skip_bin((T*)nullptr, stream);
+      }
+   }
+}
+
+template <typename First, typename Second, typename S>
+void skip_bin(std::pair<First, Second>*, S& stream) {
+   skip_bin((First*)nullptr, stream);
+   skip_bin((Second*)nullptr, stream);
+}
+
+template <typename T, typename S>
+void skip_bin(T*, S& stream) {
+   if constexpr (has_bitwise_serialization<T>()) {
+      stream.skip(sizeof(T));
+   } else if constexpr (std::is_same_v<serialization_type<T>, void> && reflection::has_for_each_field_v<T>) {
+      alaio_for_each_field((T*)nullptr, [&](const char*, auto member) {
+         using M = decltype(member((T*)nullptr));
+         if constexpr (std::is_member_object_pointer_v<M>) {
+            skip_bin((reflection::member_object_type_t<M>*)nullptr, stream);
+         }
+      });
+   } else {
+      T temp;
+      from_bin(temp, stream);
+   }
+}
+
 template <typename T>
 void convert_from_bin(T& obj, const std::vector<char>& bin) {
    input_stream stream{ bin };
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <array>
 #include <cstdlib>
 #include "for_each_field.hpp"
 #include "check.hpp"
+#include "number_format.hpp"
 #include <functional>
 #include <optional>
 #include <rapidjson/reader.h>
@@ -385,33 +387,22 @@ void from_json(std::string& result, S& stream) {
 /// \exclude
 template <typename T, typename S>
 void from_json_int(T& result, S& stream) {
-   auto r = stream.get_string();
+   using U    = std::conditional_t<(sizeof(T) > sizeof(uint64_t)), make_unsigned_t<T>, uint64_t>;
+   auto r     = stream.get_string();
    auto pos   = r.data();
    auto end   = pos + r.size();
-   bool found = false;
-   result     = 0;
-   T limit;
-   T sign;
-   if (std::is_signed_v<T> && pos != end && *pos == '-') {
+   bool neg   = std::is_signed_v<T> && pos != end && *pos == '-';
+   U    limit = U(std::numeric_limits<T>::max());
+   if (neg) {
       ++pos;
-      sign  = -1;
-      limit = std::numeric_limits<T>::min();
-   } else {
-      sign  = 1;
-      limit = std::numeric_limits<T>::max();
+      ++limit;
    }
-   while (pos != end && *pos >= '0' && *pos <= '9') {
-      T digit = (*pos++ - '0');
-      // abs(result) can overflow.  Use -abs(result) instead.
-      // TODO refactor this logic, don't have time now
-      check(!(std::is_signed_v<T> && (-sign * limit + digit) / 10 > -sign * result),
-            convert_json_error(from_json_error::number_out_of_range) );
-      check(!(!std::is_signed_v<T> && (limit - digit) / 10 < result),
-            convert_json_error(from_json_error::number_out_of_range) );
-      result = result * 10 + sign * digit;
-      found  = true;
-   }
-   check( pos == end && found, convert_json_error(from_json_error::expected_int) );
+   auto digits = pos;
+   U    value  = 0;
+   bool fits   = parse_decimal(value, pos, end);
+   check( pos != digits && pos == end, convert_json_error(from_json_error::expected_int) );
+   check( fits && value <= limit, convert_json_error(from_json_error::number_out_of_range) );
+   result = neg ? T(U(0) - value) : T(value);
 }
 
 /// \group from_json_explicit
@@ -480,25 +471,12 @@ void from_json(__int128& result, S& stream) {
 
 template <typename S>
 void from_json(float& result, S& stream) {
-   auto sv = stream.get_string();
-   check( !sv.empty(), convert_json_error(from_json_error::expected_number) );
-   std::string s(sv); // strtof expects a null-terminated string
-   errno = 0;
-   char* end;
-   result = std::strtof(s.c_str(), &end);
-   check( !errno && end == s.c_str() + s.size(),
-         convert_json_error(from_json_error::expected_number) );
+   check( parse_float(result, stream.get_string()), convert_json_error(from_json_error::expected_number) );
 }
 
 template <typename S>
 void from_json(double& result, S& stream) {
-   auto sv = stream.get_string();
-   check( !sv.empty(), convert_json_error(from_json_error::expected_number) );
-   std::string s(sv);
-   errno = 0;
-   char* end;
-   result = std::strtod(s.c_str(), &end);
-   check( !errno && end == s.c_str() + s.size(), convert_json_error(from_json_error::expected_number) );
+   check( parse_float(result, stream.get_string()), convert_json_error(from_json_error::expected_number) );
 }
 
 /*
@@ -646,21 +624,79 @@ void from_json_skip_value(S& stream) {
    } while (depth);
 }
 
+/// \exclude
+/// Reflected fields of T with their parsers, built at compile time. find() is a binary search over the names.
+template <typename T, typename S>
+struct json_field_table {
+   struct field {
+      std::string_view name;
+      void (*parse)(T&, S&);
+   };
+
+   template <auto Member>
+   static void parse(T& obj, S& stream) {
+      from_json(obj.*Member, stream);
+   }
+
+   static constexpr std::size_t size = reflection::num_fields<T>();
+
+   static constexpr std::array<field, size> make_fields() {
+      std::array<field, size> result{};
+      std::size_t             i = 0;
+      alaio_for_each_field((T*)nullptr, [&](const char* name, auto member) {
+         if constexpr (std::is_member_object_pointer_v<decltype(member((T*)nullptr))>) {
+            constexpr auto m = member((T*)nullptr);
+            result[i++]      = { name, &parse<m> };
+         }
+      });
+      return result;
+   }
+
+   static constexpr std::array<field, size> fields = make_fields();
+
+   // Indexes into fields ordered by name; insertion sort keeps equal names in declaration order
+   static constexpr std::array<std::size_t, size> make_sorted() {
+      std::array<std::size_t, size> result{};
+      for (std::size_t i = 0; i < size; ++i) {
+         std::size_t j = i;
+         for (; j > 0 && fields[i].name < fields[result[j - 1]].name; --j) result[j] = result[j - 1];
+         result[j] = i;
+      }
+      return result;
+   }
+
+   static constexpr std::array<std::size_t, size> sorted = make_sorted();
+
+   // Returns the index of the first field named key, or size
+   static std::size_t find(std::string_view key) {
+      std::size_t lo = 0, hi = size;
+      while (lo < hi) {
+         std::size_t mid = lo + (hi - lo) / 2;
+         if (fields[sorted[mid]].name < key)
+            lo = mid + 1;
+         else
+            hi = mid;
+      }
+      return lo < size && fields[sorted[lo]].name == key ? sorted[lo] : size;
+   }
+};
+
 /// \output_section Parse JSON (Reflected Objects)
 /// Parse JSON and convert to `obj`. This overload works with
 /// [reflected objects](standardese://reflection/).
 template <typename T, typename S>
 void from_json(T& obj, S& stream) {
+   using table = json_field_table<T, S>;
+   // Serializers write fields in declaration order, so the field after the previous key is checked first
+   std::size_t next = 0;
    from_json_object(stream, [&](std::string_view key) {
-      bool found = false;
-      alaio::for_each_field<T>([&](std::string_view member_name, auto member) {
-         if (!found && key == member_name) {
-            from_json(member(&obj), stream);
-            found = true;
-         }
-      });
-      if (!found)
+      std::size_t i = next < table::size && table::fields[next].name == key ? next : table::find(key);
+      if (i < table::size) {
+         table::fields[i].parse(obj, stream);
+         next = i + 1;
+      } else {
          from_json_skip_value(stream);
+      }
    });
 }
 
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include <utility>
+
+namespace alaio {
+
+/**
+ * Lock-free table of pre-rendered JSON strings, quotes included, for name, symbol_code and symbol values. to_json of
+ * those types copies the stored bytes instead of formatting when a dictionary is installed.
+ *
+ * A value is admitted once it has been seen admit_after times; the count needed doubles, up to 255, with each quarter
+ * of the table that fills up, so values which repeat often claim the space. Entries are never replaced, and the table
+ * stops admitting when it is 3/4 full. Any number of threads may share one dictionary.
+ */
+class json_dictionary {
+ public:
+   enum class kind : uint8_t { name = 1, symbol_code, symbol };
+
+   // Longest rendered value
+   static constexpr std::size_t max_size = 15;
+
+   explicit json_dictionary(std::size_t capacity = 4096, uint32_t admit_after = 2) : admit_after{ admit_after } {
+      while (mask + 1 < capacity) mask = mask * 2 + 1;
+      slots.reset(new slot[mask + 1]());
+      counts.reset(new std::atomic<uint8_t>[mask + 1]());
+   }
+
+   // Writes the JSON for value to stream. On a miss, render(char* dest) writes at most max_size bytes to dest and
+   // returns the end.
+   template <typename S, typename F>
+   void write(kind k, uint64_t value, S& stream, F&& render) {
+      std::size_t h = hash(k, value);
+      for (std::size_t i = 0; i < max_probes; ++i) {
+         auto& s     = slots[(h + i) & mask];
+         auto  state = s.state.load(std::memory_order_acquire);
+         if (state == empty)
+            break;
+         if (state == uint8_t(k) && s.value == value) {
+            stream.write(s.data, s.size);
+            return;
+         }
+      }
+      char  buf[max_size];
+      char* end = render(buf);
+      stream.write(buf, end - buf);
+      if (admit(h))
+         insert(k, value, h, buf, end - buf);
+   }
+
+   // Number of stored values
+   std::size_t size() const { return used.load(std::memory_order_relaxed); }
+
+ private:
+   static constexpr uint8_t     empty      = 0;
+   static constexpr uint8_t     busy       = 0xff;
+   static constexpr std::size_t max_probes = 8;
+
+   struct slot {
+      std::atomic<uint8_t> state = empty;
+      uint8_t              size  = 0;
+      char                 data[max_size];
+      uint64_t             value = 0;
+   };
+
+   std::size_t                             mask = 0;
+   uint32_t                                admit_after;
+   std::atomic<std::size_t>                used{ 0 };
+   std::unique_ptr<slot[]>                 slots;
+   std::unique_ptr<std::atomic<uint8_t>[]> counts;
+
+   std::size_t hash(kind k, uint64_t value) const {
+      return ((value ^ (uint64_t(k) << 61)) * 0x9e37'79b9'7f4a'7c15) >> 32;
+   }
+
+   bool admit(std::size_t h) {
+      auto n = used.load(std::memory_order_relaxed);
+      if (n * 4 >= (mask + 1) * 3)
+         return false;
+      auto& count = counts[h & mask];
+      auto  c     = count.load(std::memory_order_relaxed);
+      if (c < 0xff)
+         count.store(++c, std::memory_order_relaxed);
+      // counts saturate, so the threshold must too
+      return c >= std::min<uint64_t>(uint64_t(admit_after) << (n * 4 / (mask + 1)), 0xff);
+   }
+
+   void insert(kind k, uint64_t value, std::size_t h, const char* data, std::size_t size) {
+      for (std::size_t i = 0; i < max_probes; ++i) {
+         auto&   s     = slots[(h + i) & mask];
+         uint8_t state = s.state.load(std::memory_order_acquire);
+         if (state == uint8_t(k) && s.value == value)
+            return;
+         if (state == empty && s.state.compare_exchange_strong(state, busy, std::memory_order_acquire)) {
+            s.value = value;
+            s.size  = size;
+            memcpy(s.data, data, size);
+            s.state.store(uint8_t(k), std::memory_order_release);
+            used.fetch_add(1, std::memory_order_relaxed);
+            return;
+         }
+      }
+   }
+};
+
+inline std::atomic<json_dictionary*>  shared_json_dictionary{ nullptr };
+inline thread_local json_dictionary* scoped_json_dictionary = nullptr;
+
+// Installs a dictionary for every thread, or removes it when passed nullptr. It must outlive its use.
+inline void set_json_dictionary(json_dictionary* dictionary) {
+   shared_json_dictionary.store(dictionary, std::memory_order_release);
+}
+
+// The dictionary of the innermost json_dictionary_scope on this thread, else the one set by set_json_dictionary
+inline json_dictionary* get_json_dictionary() {
+   if (scoped_json_dictionary)
+      return scoped_json_dictionary;
+   return shared_json_dictionary.load(std::memory_order_acquire);
+}
+
+// The dictionary for to_json on stream. Streams with a dictionary member, such as string_stream, looked it up when they
+// were created, so a conversion into one checks only once.
+template <typename S, typename = void>
+struct has_json_dictionary : std::false_type {};
+
+template <typename S>
+struct has_json_dictionary<S, std::enable_if_t<std::is_same_v<decltype(std::declval<S&>().dictionary),
+                                                              json_dictionary*>>> : std::true_type {};
+
+template <typename S>
+json_dictionary* get_json_dictionary(S& stream) {
+   if constexpr (has_json_dictionary<S>::value)
+      return stream.dictionary;
+   else
+      return get_json_dictionary();
+}
+
+// Uses a dictionary on the current thread until destroyed
+class json_dictionary_scope {
+ public:
+   explicit json_dictionary_scope(json_dictionary* dictionary) : prev{ scoped_json_dictionary } {
+      scoped_json_dictionary = dictionary;
+   }
+   ~json_dictionary_scope() { scoped_json_dictionary = prev; }
+
+   json_dictionary_scope(const json_dictionary_scope&) = delete;
+   json_dictionary_scope& operator=(const json_dictionary_scope&) = delete;
+
+ private:
+   json_dictionary* prev;
+};
+
+} // namespace alaio
@@ -2,6 +2,7 @@
 
 #include "chain_conversions.hpp"
 #include "check.hpp"
+#include "json_dictionary.hpp"
 #include "operators.hpp"
 #include "reflection.hpp"
 #include "murmur.hpp"
@@ -156,9 +157,21 @@ void from_json(name& obj, S& stream) {
    obj = name(hash_name(r));
 }
 
+// Name characters never need escaping, so the quoted string is written as is
 template <typename S>
 void to_json(const name& obj, S& stream) {
-   to_json(alaio::name_to_string(obj.value), stream);
+   auto render = [&](char* dest) {
+      *dest++ = '"';
+      dest    = name_to_chars(obj.value, dest);
+      *dest++ = '"';
+      return dest;
+   };
+   if (auto* dictionary = get_json_dictionary(stream))
+      dictionary->write(json_dictionary::kind::name, obj.value, stream, render);
+   else {
+      char buf[json_dictionary::max_size];
+      stream.write(buf, render(buf) - buf);
+   }
 }
 
 inline namespace literals {
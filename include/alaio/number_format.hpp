@@ -0,0 +1,253 @@
+#pragma once
+
+#include "fpconv.h"
+
+#include <charconv>
+#include <errno.h>
+#include <limits>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace alaio {
+
+template <typename T>
+struct make_unsigned : std::make_unsigned<T> {};
+
+#ifndef ABIALA_NO_INT128
+// some standard library does not support std::make_unsigned<__int128> yet. 
+template <>
+struct make_unsigned<__int128> {
+   using type = unsigned __int128;
+};
+
+template <>
+struct make_unsigned<unsigned __int128> {
+   using type = unsigned __int128;
+};
+#endif
+
+template <typename T>
+using make_unsigned_t = typename make_unsigned<T>::type;
+
+inline constexpr char digit_pairs[] = "00010203040506070809101112131415161718192021222324"
+                                       "25262728293031323334353637383940414243444546474849"
+                                       "50515253545556575859606162636465666768697071727374"
+                                       "75767778798081828384858687888990919293949596979899";
+
+inline int decimal_digits(uint64_t value) {
+   int n = 1;
+   while (true) {
+      if (value < 10)
+         return n;
+      if (value < 100)
+         return n + 1;
+      if (value < 1000)
+         return n + 2;
+      if (value < 10000)
+         return n + 3;
+      value /= 10000;
+      n += 4;
+   }
+}
+
+// Writes the lowest n decimal digits of value, zero padded, to the n characters before end
+inline void write_decimal_digits(uint64_t value, char* end, int n) {
+   for (; n >= 2; n -= 2) {
+      end -= 2;
+      memcpy(end, digit_pairs + (value % 100) * 2, 2);
+      value /= 100;
+   }
+   if (n)
+      *--end = '0' + value % 10;
+}
+
+inline char* uint64_to_decimal(uint64_t value, char* buffer) {
+   int n = decimal_digits(value);
+   write_decimal_digits(value, buffer + n, n);
+   return buffer + n;
+}
+
+// Writes value in decimal, two digits per division. Returns the end of the output; 128-bit values need 40 characters.
+template <typename T>
+char* int_to_decimal(T value, char* buffer) {
+   auto uvalue = make_unsigned_t<T>(value);
+   if (value < 0) {
+      *buffer++ = '-';
+      uvalue    = -uvalue;
+   }
+   if constexpr (sizeof(uvalue) <= sizeof(uint64_t)) {
+      return uint64_to_decimal(uvalue, buffer);
+   } else {
+      // Split into 19-digit chunks so that the digit loop runs on 64-bit values
+      constexpr uint64_t chunk = 10'000'000'000'000'000'000ull;
+      if (uvalue <= UINT64_MAX)
+         return uint64_to_decimal(uint64_t(uvalue), buffer);
+      uint64_t low = uint64_t(uvalue % chunk);
+      uvalue /= chunk;
+      if (uvalue <= UINT64_MAX) {
+         buffer = uint64_to_decimal(uint64_t(uvalue), buffer);
+      } else {
+         buffer = uint64_to_decimal(uint64_t(uvalue / chunk), buffer);
+         write_decimal_digits(uint64_t(uvalue % chunk), buffer + 19, 19);
+         buffer += 19;
+      }
+      write_decimal_digits(low, buffer + 19, 19);
+      return buffer + 19;
+   }
+}
+
+// Writes the shortest decimal which reads back as value, using at most 25 characters. value must be finite. Floats
+// are formatted at their own precision. The layout is javascript's: plain notation for 1e-6 <= |value| < 1e21, else
+// d.ddde-7 or d.ddde+21. Falls back to fpconv (Grisu2, doubles only) when the standard library has no floating-point
+// to_chars.
+template <typename T>
+char* float_to_shortest(T value, char* buffer) {
+#ifdef __cpp_lib_to_chars
+   // to_chars gives the digits and exponent as -d.ddde-dd; place the decimal point here
+   char        sci[32];
+   const char* end = std::to_chars(sci, sci + sizeof(sci), value, std::chars_format::scientific).ptr;
+   const char* p   = sci;
+   if (*p == '-')
+      *buffer++ = *p++;
+   char digits[24];
+   int  num_digits = 0;
+   digits[num_digits++] = *p++;
+   if (*p == '.')
+      for (++p; *p != 'e'; ++p) digits[num_digits++] = *p;
+   bool negative_exp = p[1] == '-';
+   int  exp          = 0;
+   for (p += 2; p != end; ++p) exp = exp * 10 + (*p - '0');
+   if (negative_exp)
+      exp = -exp;
+
+   // digits before the decimal point
+   int point = exp + 1;
+   if (num_digits <= point && point <= 21) {
+      memcpy(buffer, digits, num_digits);
+      memset(buffer + num_digits, '0', point - num_digits);
+      return buffer + point;
+   }
+   if (0 < point && point <= 21) {
+      memcpy(buffer, digits, point);
+      buffer[point] = '.';
+      memcpy(buffer + point + 1, digits + point, num_digits - point);
+      return buffer + num_digits + 1;
+   }
+   if (-6 < point && point <= 0) {
+      *buffer++ = '0';
+      *buffer++ = '.';
+      memset(buffer, '0', -point);
+      memcpy(buffer - point, digits, num_digits);
+      return buffer - point + num_digits;
+   }
+   *buffer++ = digits[0];
+   if (num_digits > 1) {
+      *buffer++ = '.';
+      memcpy(buffer, digits + 1, num_digits - 1);
+      buffer += num_digits - 1;
+   }
+   *buffer++ = 'e';
+   *buffer++ = exp < 0 ? '-' : '+';
+   return uint64_to_decimal(exp < 0 ? -exp : exp, buffer);
+#else
+   return buffer + fpconv_dtoa(value, buffer);
+#endif
+}
+
+// True if the 8 bytes at p are all decimal digits
+inline bool is_eight_digits(const char* p) {
+   uint64_t v;
+   memcpy(&v, p, sizeof(v));
+   return !(((v + 0x4646464646464646) | (v - 0x3030303030303030)) & 0x8080808080808080);
+}
+
+// Value of the 8 decimal digits at p, combined pairwise in three multiplies (SWAR); assumes a little-endian host
+inline uint32_t parse_eight_digits(const char* p) {
+   uint64_t v;
+   memcpy(&v, p, sizeof(v));
+   v -= 0x3030303030303030;
+   v = (v * 10) + (v >> 8);
+   v = (((v & 0x000000FF000000FF) * (100 + (1000000ull << 32))) +
+        (((v >> 16) & 0x000000FF000000FF) * (1 + (10000ull << 32)))) >>
+       32;
+   return uint32_t(v);
+}
+
+// Parses the decimal digits at the start of [pos, end), advancing pos past them. Returns false if there are none or
+// the value does not fit in U. Leading zeros are skipped, so the digit count alone rules out overflow except on the
+// last digit of a maximum-length number, which is the only step that is checked.
+template <typename U>
+bool parse_decimal(U& result, const char*& pos, const char* end) {
+   // numeric_limits<unsigned __int128>::digits10 is 0 in older libstdc++ in strict mode
+   constexpr int safe_digits = sizeof(U) == 16 ? 38 : std::numeric_limits<U>::digits10;
+   const char*   begin       = pos;
+   while (pos != end && *pos == '0') ++pos;
+   const char* first = pos;
+   while (pos != end && *pos >= '0' && *pos <= '9') ++pos;
+   if (pos == begin || pos - first > safe_digits + 1)
+      return false;
+   const char* last = pos - first > safe_digits ? pos - 1 : pos;
+   U           value = 0;
+   const char* p     = first;
+   for (; last - p >= 8; p += 8) value = value * 100000000 + parse_eight_digits(p);
+   for (; p != last; ++p) value = value * 10 + (*p - '0');
+   if (last != pos &&
+       (__builtin_mul_overflow(value, U(10), &value) || __builtin_add_overflow(value, U(*last - '0'), &value)))
+      return false;
+   result = value;
+   return true;
+}
+
+// Appends the decimal digits at the start of [pos, end) to value, advancing pos past them. Returns the number of
+// digits, or -1 if value overflows.
+inline int append_decimal_digits(uint64_t& value, const char*& pos, const char* end) {
+   const char* begin = pos;
+   // 10 digits followed by 8 more still fit in 64 bits
+   for (; end - pos >= 8 && value < 10'000'000'000 && is_eight_digits(pos); pos += 8)
+      value = value * 100000000 + parse_eight_digits(pos);
+   for (; pos != end && *pos >= '0' && *pos <= '9'; ++pos)
+      if (__builtin_mul_overflow(value, uint64_t(10), &value) ||
+          __builtin_add_overflow(value, uint64_t(*pos - '0'), &value))
+         return -1;
+   return pos - begin;
+}
+
+// Parses all of s as a float or double, rounding correctly. Accepts what strtod does for JSON numbers, plus a leading
+// '+' and the infinity and nan spellings. Uses the standard library's from_chars (fast_float in libstdc++) when it
+// supports floating point, otherwise strtod on a stack copy.
+template <typename T>
+bool parse_float(T& result, std::string_view s) {
+   if (!s.empty() && s[0] == '+') {
+      s.remove_prefix(1);
+      if (!s.empty() && s[0] == '-')
+         return false;
+   }
+#ifdef __cpp_lib_to_chars
+   auto r = std::from_chars(s.data(), s.data() + s.size(), result);
+   return r.ec == std::errc{} && r.ptr == s.data() + s.size();
+#else
+   char        buf[64];
+   std::string large;
+   const char* str = buf;
+   if (s.size() < sizeof(buf)) {
+      memcpy(buf, s.data(), s.size());
+      buf[s.size()] = 0;
+   } else {
+      large = s;
+      str   = large.c_str();
+   }
+   errno = 0;
+   char* end;
+   if constexpr (std::is_same_v<T, float>)
+      result = strtof(str, &end);
+   else
+      result = strtod(str, &end);
+   return !s.empty() && !errno && end == str + s.size();
+#endif
+}
+
+} // namespace alaio
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "map_macro.h"
+#include <cstddef>
 #include <type_traits>
 
 namespace alaio { namespace reflection {
@@ -26,6 +27,29 @@ namespace alaio { namespace reflection {
    template <typename T>
    inline constexpr bool has_for_each_field_v = has_for_each_field<T>::value;
 
+   template <typename M>
+   struct member_object_type;
+
+   template <typename C, typename M>
+   struct member_object_type<M C::*> {
+      using type = M;
+   };
+
+   // Type of the member a pointer to data member refers to
+   template <typename M>
+   using member_object_type_t = typename member_object_type<M>::type;
+
+   // Number of reflected data members of T, including those of its reflected bases
+   template <typename T>
+   constexpr std::size_t num_fields() {
+      std::size_t result = 0;
+      alaio_for_each_field((T*)nullptr, [&](const char*, auto member) {
+         if constexpr (std::is_member_object_pointer_v<decltype(member((T*)nullptr))>)
+            ++result;
+      });
+      return result;
+   }
+
 #define ALAIO_REFLECT_MEMBER(STRUCT, FIELD)                                                                            \
    f(#FIELD, [](auto p) -> decltype(&std::decay_t<decltype(*p)>::FIELD) { return &std::decay_t<decltype(*p)>::FIELD; });
 
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "stream.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#if __has_include(<sys/uio.h>)
+#   include <sys/uio.h>
+#endif
+
+namespace alaio {
+
+// A piece of serialized output; it has the layout of struct iovec
+struct io_segment {
+   const char* data;
+   std::size_t size;
+};
+
+#if __has_include(<sys/uio.h>)
+static_assert(sizeof(io_segment) == sizeof(iovec) && offsetof(io_segment, size) == offsetof(iovec, iov_len));
+#endif
+
+/**
+ * Output stream which collects its output as segments for writev() or a gathering socket send. Writes of at least
+ * reference_threshold() bytes, such as input_stream, bytes and long string fields, are referenced where they are
+ * instead of being copied; everything else is copied into an internal buffer. The referenced data must stay unchanged
+ * until the segments have been used.
+ *
+ *    scatter_stream stream;
+ *    to_bin(result, stream);
+ *    auto& segments = stream.segments();
+ *    writev(fd, reinterpret_cast<const iovec*>(segments.data()), segments.size());
+ */
+class scatter_stream {
+ public:
+   // to_bin writes some values from temporaries, e.g. a checksum512's 64-byte array, which must always be copied
+   static constexpr std::size_t min_reference_threshold = 128;
+
+   // reference_threshold is raised to min_reference_threshold if below it
+   explicit scatter_stream(std::size_t reference_threshold = 256)
+       : threshold{ std::max(reference_threshold, min_reference_threshold) } {}
+
+   std::size_t reference_threshold() const { return threshold; }
+
+   void write(char c) { buffer.push_back(c); }
+
+   void write(const void* src, std::size_t sz) {
+      auto s = reinterpret_cast<const char*>(src);
+      if (sz < threshold) {
+         buffer.insert(buffer.end(), s, s + sz);
+         return;
+      }
+      end_copied_piece();
+      pieces.push_back({ s, 0, sz });
+   }
+
+   template <typename T>
+   void write_raw(const T& v) {
+      write(&v, sizeof(v));
+   }
+
+   // The output so far, in order. Valid until the next write or clear().
+   const std::vector<io_segment>& segments() {
+      end_copied_piece();
+      result.clear();
+      for (auto& p : pieces) result.push_back({ p.data ? p.data : buffer.data() + p.offset, p.size });
+      return result;
+   }
+
+   // Total size of the output so far
+   std::size_t size() const {
+      std::size_t total = buffer.size();
+      for (auto& p : pieces)
+         if (p.data)
+            total += p.size;
+      return total;
+   }
+
+   void clear() {
+      buffer.clear();
+      pieces.clear();
+      copied_begin = 0;
+   }
+
+ private:
+   // data is null for pieces of buffer, which may still move
+   struct piece {
+      const char* data;
+      std::size_t offset;
+      std::size_t size;
+   };
+
+   std::size_t             threshold;
+   std::vector<char>       buffer;
+   std::vector<piece>      pieces;
+   std::size_t             copied_begin = 0;
+   std::vector<io_segment> result;
+
+   void end_copied_piece() {
+      if (buffer.size() > copied_begin)
+         pieces.push_back({ nullptr, copied_begin, buffer.size() - copied_begin });
+      copied_begin = buffer.size();
+   }
+};
+
+} // namespace alaio
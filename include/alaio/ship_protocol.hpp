@@ -1,6 +1,7 @@
 #pragma once
 
 #include "abi.hpp"
+#include "bin_view.hpp"
 #include "check.hpp"
 #include "crypto.hpp"
 #include "fixed_bytes.hpp"
@@ -146,8 +147,9 @@ namespace alaio { namespace ship_protocol {
 
    ALAIO_REFLECT(row_v0, present, data)
 
+   // std::string_view and alaio::input_stream members refer to the data they were decoded from
    struct table_delta_v0 {
-      std::string         name = {};
+      std::string_view    name = {};
       std::vector<row_v0> rows = {};
    };
 
@@ -203,35 +205,35 @@ namespace alaio { namespace ship_protocol {
    ALAIO_COMPARE(account_delta);
 
    struct action_trace_v0 {
-      alaio::varuint32              action_ordinal         = {};
-      alaio::varuint32              creator_action_ordinal = {};
-      std::optional<action_receipt> receipt                = {};
-      alaio::name                   receiver               = {};
-      action                        act                    = {};
-      bool                          context_free           = {};
-      int64_t                       elapsed                = {};
-      std::string                   console                = {};
-      std::vector<account_delta>    account_ram_deltas     = {};
-      std::optional<std::string>    except                 = {};
-      std::optional<uint64_t>       error_code             = {};
+      alaio::varuint32                action_ordinal         = {};
+      alaio::varuint32                creator_action_ordinal = {};
+      std::optional<action_receipt>   receipt                = {};
+      alaio::name                     receiver               = {};
+      action                          act                    = {};
+      bool                            context_free           = {};
+      int64_t                         elapsed                = {};
+      std::string_view                console                = {};
+      std::vector<account_delta>      account_ram_deltas     = {};
+      std::optional<std::string_view> except                 = {};
+      std::optional<uint64_t>         error_code             = {};
    };
 
    ALAIO_REFLECT(action_trace_v0, action_ordinal, creator_action_ordinal, receipt, receiver, act, context_free, elapsed,
                  console, account_ram_deltas, except, error_code)
 
    struct action_trace_v1 {
-      alaio::varuint32              action_ordinal         = {};
-      alaio::varuint32              creator_action_ordinal = {};
-      std::optional<action_receipt> receipt                = {};
-      alaio::name                   receiver               = {};
-      action                        act                    = {};
-      bool                          context_free           = {};
-      int64_t                       elapsed                = {};
-      std::string                   console                = {};
-      std::vector<account_delta>    account_ram_deltas     = {};
-      std::optional<std::string>    except                 = {};
-      std::optional<uint64_t>       error_code             = {};
-      alaio::input_stream           return_value           = {};
+      alaio::varuint32                action_ordinal         = {};
+      alaio::varuint32                creator_action_ordinal = {};
+      std::optional<action_receipt>   receipt                = {};
+      alaio::name                     receiver               = {};
+      action                          act                    = {};
+      bool                            context_free           = {};
+      int64_t                         elapsed                = {};
+      std::string_view                console                = {};
+      std::vector<account_delta>      account_ram_deltas     = {};
+      std::optional<std::string_view> except                 = {};
+      std::optional<uint64_t>         error_code             = {};
+      alaio::input_stream             return_value           = {};
    };
 
    ALAIO_REFLECT(action_trace_v1, action_ordinal, creator_action_ordinal, receipt, receiver, act, context_free, elapsed,
@@ -268,7 +270,7 @@ namespace alaio { namespace ship_protocol {
       bool                                   scheduled         = {};
       std::vector<action_trace>              action_traces     = {};
       std::optional<account_delta>           account_ram_delta = {};
-      std::optional<std::string>             except            = {};
+      std::optional<std::string_view>        except            = {};
       std::optional<uint64_t>                error_code        = {};
       // semantically, this should be std::optional<transaction_trace>;
       // optional serializes as bool[,transaction_trace]
@@ -823,6 +825,11 @@ namespace alaio {
       return from_bin(obj.recurse, stream);
    }
 
+   template <typename S>
+   void skip_bin(ship_protocol::recurse_transaction_trace*, S& stream) {
+      return skip_bin((ship_protocol::transaction_trace*)nullptr, stream);
+   }
+
    template <typename S>
    void to_json(const ship_protocol::recurse_transaction_trace& obj, S& stream) {
       return to_json(obj.recurse, stream);
@@ -848,3 +855,47 @@ namespace alaio {
    }
 
 }
+
+namespace alaio {
+
+   template <>
+   struct bin_view_traits<ship_protocol::recurse_transaction_trace>;
+
+} // namespace alaio
+
+namespace alaio { namespace ship_protocol {
+
+   // Lazy views of serialized traces, deltas and blocks; see bin_view
+   ALAIO_BIN_VIEW(action, account, name, authorization, data)
+   ALAIO_BIN_VIEW(action_receipt_v0, receiver, act_digest, global_sequence, recv_sequence, auth_sequence,
+                  code_sequence, abi_sequence)
+   ALAIO_BIN_VIEW(action_trace_v0, action_ordinal, creator_action_ordinal, receipt, receiver, act, context_free,
+                  elapsed, console, account_ram_deltas, except, error_code)
+   ALAIO_BIN_VIEW(action_trace_v1, action_ordinal, creator_action_ordinal, receipt, receiver, act, context_free,
+                  elapsed, console, account_ram_deltas, except, error_code, return_value)
+   ALAIO_BIN_VIEW(partial_transaction_v0, expiration, ref_block_num, ref_block_prefix, max_net_usage_words,
+                  max_cpu_usage_ms, delay_sec, transaction_extensions, signatures, context_free_data)
+   ALAIO_BIN_VIEW(transaction_trace_v0, id, status, cpu_usage_us, net_usage_words, elapsed, net_usage, scheduled,
+                  action_traces, account_ram_delta, except, error_code, failed_dtrx_trace, partial)
+   ALAIO_BIN_VIEW(table_delta_v0, name, rows)
+   ALAIO_BIN_VIEW(packed_transaction, signatures, compression, packed_context_free_data, packed_trx)
+   ALAIO_BIN_VIEW(transaction_receipt_v0, status, cpu_usage_us, net_usage_words, trx)
+   ALAIO_BIN_VIEW(signed_block, timestamp, producer, confirmed, previous, transaction_mroot, action_mroot,
+                  schedule_version, new_producers, header_extensions, producer_signature, transactions,
+                  block_extensions)
+
+   using action_trace_view      = alaio::bin_view_t<action_trace>;
+   using transaction_trace_view = alaio::bin_view_t<transaction_trace>;
+   using table_delta_view       = alaio::bin_view_t<table_delta>;
+
+}} // namespace alaio::ship_protocol
+
+namespace alaio {
+
+   template <>
+   struct bin_view_traits<ship_protocol::recurse_transaction_trace> {
+      using type = ship_protocol::transaction_trace_view;
+      static type read(input_stream stream) { return bin_view_traits<ship_protocol::transaction_trace>::read(stream); }
+   };
+
+} // namespace alaio
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "arena_stream.hpp"
+#include "ship_protocol.hpp"
+
+namespace alaio { namespace ship_protocol { namespace pmr {
+
+   // Variants of the trace and delta types which allocate through std::pmr; decode them with arena_input_stream.
+   // They serialize like their ship_protocol counterparts.
+
+   struct table_delta_v0 {
+      std::pmr::string         name = {};
+      std::pmr::vector<row_v0> rows = {};
+   };
+
+   ALAIO_REFLECT(table_delta_v0, name, rows)
+
+   using table_delta = std::variant<table_delta_v0>;
+
+   struct action {
+      alaio::name                        account       = {};
+      alaio::name                        name          = {};
+      std::pmr::vector<permission_level> authorization = {};
+      alaio::input_stream                data          = {};
+   };
+
+   ALAIO_REFLECT(action, account, name, authorization, data)
+
+   struct action_receipt_v0 {
+      alaio::name                             receiver        = {};
+      alaio::checksum256                      act_digest      = {};
+      uint64_t                                global_sequence = {};
+      uint64_t                                recv_sequence   = {};
+      std::pmr::vector<account_auth_sequence> auth_sequence   = {};
+      alaio::varuint32                        code_sequence   = {};
+      alaio::varuint32                        abi_sequence    = {};
+   };
+
+   ALAIO_REFLECT(action_receipt_v0, receiver, act_digest, global_sequence, recv_sequence, auth_sequence, code_sequence,
+                 abi_sequence)
+
+   using action_receipt = std::variant<action_receipt_v0>;
+
+   struct action_trace_v0 {
+      alaio::varuint32                action_ordinal         = {};
+      alaio::varuint32                creator_action_ordinal = {};
+      std::optional<action_receipt>   receipt                = {};
+      alaio::name                     receiver               = {};
+      action                          act                    = {};
+      bool                            context_free           = {};
+      int64_t                         elapsed                = {};
+      std::pmr::string                console                = {};
+      std::pmr::vector<account_delta> account_ram_deltas     = {};
+      std::optional<std::pmr::string> except                 = {};
+      std::optional<uint64_t>         error_code             = {};
+   };
+
+   ALAIO_REFLECT(action_trace_v0, action_ordinal, creator_action_ordinal, receipt, receiver, act, context_free, elapsed,
+                 console, account_ram_deltas, except, error_code)
+
+   struct action_trace_v1 {
+      alaio::varuint32                action_ordinal         = {};
+      alaio::varuint32                creator_action_ordinal = {};
+      std::optional<action_receipt>   receipt                = {};
+      alaio::name                     receiver               = {};
+      action                          act                    = {};
+      bool                            context_free           = {};
+      int64_t                         elapsed                = {};
+      std::pmr::string                console                = {};
+      std::pmr::vector<account_delta> account_ram_deltas     = {};
+      std::optional<std::pmr::string> except                 = {};
+      std::optional<uint64_t>         error_code             = {};
+      alaio::input_stream             return_value           = {};
+   };
+
+   ALAIO_REFLECT(action_trace_v1, action_ordinal, creator_action_ordinal, receipt, receiver, act, context_free, elapsed,
+                 console, account_ram_deltas, except, error_code, return_value)
+
+   using action_trace = std::variant<action_trace_v0, action_trace_v1>;
+
+   struct partial_transaction_v0 {
+      alaio::time_point_sec                 expiration             = {};
+      uint16_t                              ref_block_num          = {};
+      uint32_t                              ref_block_prefix       = {};
+      alaio::varuint32                      max_net_usage_words    = {};
+      uint8_t                               max_cpu_usage_ms       = {};
+      alaio::varuint32                      delay_sec              = {};
+      std::pmr::vector<extension>           transaction_extensions = {};
+      std::pmr::vector<alaio::signature>    signatures             = {};
+      std::pmr::vector<alaio::input_stream> context_free_data      = {};
+   };
+
+   ALAIO_REFLECT(partial_transaction_v0, expiration, ref_block_num, ref_block_prefix, max_net_usage_words,
+                 max_cpu_usage_ms, delay_sec, transaction_extensions, signatures, context_free_data)
+
+   using partial_transaction = std::variant<partial_transaction_v0>;
+
+   struct recurse_transaction_trace;
+
+   struct transaction_trace_v0 {
+      alaio::checksum256                          id                = {};
+      transaction_status                          status            = {};
+      uint32_t                                    cpu_usage_us      = {};
+      alaio::varuint32                            net_usage_words   = {};
+      int64_t                                     elapsed           = {};
+      uint64_t                                    net_usage         = {};
+      bool                                        scheduled         = {};
+      std::pmr::vector<action_trace>              action_traces     = {};
+      std::optional<account_delta>                account_ram_delta = {};
+      std::optional<std::pmr::string>             except            = {};
+      std::optional<uint64_t>                     error_code        = {};
+      std::pmr::vector<recurse_transaction_trace> failed_dtrx_trace = {};
+      std::optional<partial_transaction>          partial           = {};
+   };
+
+   ALAIO_REFLECT(transaction_trace_v0, id, status, cpu_usage_us, net_usage_words, elapsed, net_usage, scheduled,
+                 action_traces, account_ram_delta, except, error_code, failed_dtrx_trace, partial)
+
+   using transaction_trace = std::variant<transaction_trace_v0>;
+
+   struct recurse_transaction_trace {
+      transaction_trace recurse = {};
+   };
+
+}}} // namespace alaio::ship_protocol::pmr
+
+namespace alaio {
+
+   template <typename S>
+   void to_bin(const ship_protocol::pmr::recurse_transaction_trace& obj, S& stream) {
+      return to_bin(obj.recurse, stream);
+   }
+
+   template <typename S>
+   void from_bin(ship_protocol::pmr::recurse_transaction_trace& obj, S& stream) {
+      return from_bin(obj.recurse, stream);
+   }
+
+   template <typename S>
+   void skip_bin(ship_protocol::pmr::recurse_transaction_trace*, S& stream) {
+      return skip_bin((ship_protocol::pmr::transaction_trace*)nullptr, stream);
+   }
+
+   template <typename S>
+   void to_json(const ship_protocol::pmr::recurse_transaction_trace& obj, S& stream) {
+      return to_json(obj.recurse, stream);
+   }
+
+   template <typename S>
+   void to_json(const std::pmr::vector<ship_protocol::pmr::recurse_transaction_trace>& obj, S& stream) {
+      if (!obj.empty()) {
+         to_json(obj[0], stream);
+      } else {
+         stream.write("null", 4);
+      }
+   }
+
+} // namespace alaio
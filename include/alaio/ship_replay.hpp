@@ -0,0 +1,260 @@
+#pragma once
+
+#include "from_bin.hpp"
+#include "ship_protocol.hpp"
+#include "to_bin.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <optional>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace alaio {
+
+/**
+ * A replay file holds captured state-history messages, each one a serialized `ship_protocol::result` as sent by the
+ * node, preceded by its size as a little-endian uint32.
+ */
+struct ship_replay_index_entry {
+   uint32_t block_num = {};
+   uint64_t offset    = {}; // of the size prefix
+};
+
+ALAIO_REFLECT(ship_replay_index_entry, block_num, offset)
+
+/**
+ * Index stored next to a replay file as `<path>.index`. Entries are sorted by block_num; when a block appears more
+ * than once (a fork was captured) the last copy wins. file_size is the part of the replay file the index covers.
+ */
+struct ship_replay_index {
+   uint32_t                             version   = 1;
+   uint64_t                             file_size = {};
+   std::vector<ship_replay_index_entry> entries   = {};
+};
+
+ALAIO_REFLECT(ship_replay_index, version, file_size, entries)
+
+namespace detail {
+   // Side files (index, summary) are a single serialized object. Returns false if the file does not exist.
+   template <typename T>
+   bool load_replay_side_file(const std::string& path, T& obj) {
+      std::FILE* f = std::fopen(path.c_str(), "rb");
+      if (!f)
+         return false;
+      std::vector<char> bin;
+      char              buf[65536];
+      while (auto n = std::fread(buf, 1, sizeof(buf), f)) bin.insert(bin.end(), buf, buf + n);
+      std::fclose(f);
+      input_stream stream{ bin };
+      from_bin(obj, stream);
+      return true;
+   }
+
+   template <typename T>
+   void save_replay_side_file(const std::string& path, const T& obj) {
+      auto       bin  = convert_to_bin(obj);
+      auto       temp = path + ".tmp";
+      std::FILE* f    = std::fopen(temp.c_str(), "wb");
+      check(f != nullptr, "can not create " + temp + ": " + std::strerror(errno));
+      bool ok = std::fwrite(bin.data(), 1, bin.size(), f) == bin.size();
+      ok      = std::fclose(f) == 0 && ok;
+      check(ok && std::rename(temp.c_str(), path.c_str()) == 0, "can not write " + path);
+   }
+} // namespace detail
+
+struct ship_replay_message {
+   input_stream                        data   = {}; // the whole serialized result
+   ship_protocol::get_blocks_result_v0 result = {}; // block, traces and deltas reference data
+};
+
+/**
+ * Read-only view of a memory-mapped replay file. Messages and their block/traces/deltas reference the mapping and
+ * stay valid for the lifetime of the ship_replay_file.
+ */
+class ship_replay_file {
+ public:
+   static constexpr uint32_t index_version = 1;
+
+   // Bytes advised ahead of the current message while iterating with for_each
+   std::size_t prefetch_size = 64 * 1024 * 1024;
+
+   // Loads `<path>.index` if present, indexes any part of the file it does not cover, and rewrites it when it changed
+   explicit ship_replay_file(const std::string& path, bool use_index_file = true) : path(path) {
+      int fd = ::open(path.c_str(), O_RDONLY);
+      check(fd >= 0, "can not open " + path + ": " + std::strerror(errno));
+      struct stat st;
+      if (::fstat(fd, &st) < 0) {
+         int err = errno;
+         ::close(fd);
+         check(false, "can not stat " + path + ": " + std::strerror(err));
+      }
+      size = st.st_size;
+      if (size) {
+         void* p = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+         int   err = errno;
+         ::close(fd);
+         check(p != MAP_FAILED, "can not map " + path + ": " + std::strerror(err));
+         data = static_cast<const char*>(p);
+      } else {
+         ::close(fd);
+      }
+
+      try {
+         bool loaded = use_index_file && load_index();
+         if (!loaded || index.file_size < size) {
+            build_index();
+            if (use_index_file)
+               save_index();
+         }
+      } catch (...) {
+         if (data)
+            ::munmap(const_cast<char*>(data), size);
+         throw;
+      }
+   }
+
+   ship_replay_file(const ship_replay_file&) = delete;
+   ship_replay_file& operator=(const ship_replay_file&) = delete;
+
+   ~ship_replay_file() {
+      if (data)
+         ::munmap(const_cast<char*>(data), size);
+   }
+
+   const std::string&                          get_path() const { return path; }
+   const std::vector<ship_replay_index_entry>& entries() const { return index.entries; }
+
+   // Index of the first entry with block_num >= block_num
+   std::size_t lower_bound(uint32_t block_num) const {
+      return std::lower_bound(index.entries.begin(), index.entries.end(), block_num,
+                              [](const ship_replay_index_entry& e, uint32_t b) { return e.block_num < b; }) -
+             index.entries.begin();
+   }
+
+   ship_replay_message get(std::size_t entry) const {
+      check(entry < index.entries.size(), "replay file entry out of range");
+      ship_replay_message msg;
+      msg.data = message_at(index.entries[entry].offset);
+      decode(msg);
+      return msg;
+   }
+
+   std::optional<ship_replay_message> find(uint32_t block_num) const {
+      auto i = lower_bound(block_num);
+      if (i == index.entries.size() || index.entries[i].block_num != block_num)
+         return {};
+      return get(i);
+   }
+
+   // Hints the kernel to read the messages for entries [first, last) ahead of use
+   void prefetch(std::size_t first, std::size_t last) const {
+      if (first >= last || last > index.entries.size())
+         return;
+      uint64_t begin = index.entries[first].offset;
+      uint64_t end   = last < index.entries.size() ? index.entries[last].offset : index.file_size;
+      advise(begin, end, MADV_WILLNEED);
+   }
+
+   // Calls f(const ship_replay_message&) for every indexed block in [first_block, end_block), in order
+   template <typename F>
+   void for_each(uint32_t first_block, uint32_t end_block, F&& f) const {
+      uint64_t prefetched = 0;
+      for (auto i = lower_bound(first_block); i < index.entries.size() && index.entries[i].block_num < end_block;
+           ++i) {
+         uint64_t offset = index.entries[i].offset;
+         if (offset + prefetch_size / 2 >= prefetched) {
+            uint64_t end = std::min<uint64_t>(offset + prefetch_size, size);
+            advise(std::max(prefetched, offset), end, MADV_WILLNEED);
+            prefetched = end;
+         }
+         f(get(i));
+      }
+   }
+
+ private:
+   std::string       path;
+   const char*       data = nullptr;
+   uint64_t          size = 0;
+   ship_replay_index index;
+
+   void advise(uint64_t begin, uint64_t end, int advice) const {
+      if (!data || begin >= end)
+         return;
+      static const uint64_t page = ::sysconf(_SC_PAGESIZE);
+      begin &= ~(page - 1);
+      ::madvise(const_cast<char*>(data) + begin, end - begin, advice);
+   }
+
+   input_stream message_at(uint64_t offset) const {
+      check(offset <= size && size - offset >= 4, "replay file truncated");
+      uint32_t msg_size;
+      memcpy(&msg_size, data + offset, sizeof(msg_size));
+      check(size - offset - 4 >= msg_size, "replay file truncated");
+      return { data + offset + 4, msg_size };
+   }
+
+   static void decode(ship_replay_message& msg) {
+      auto     stream = msg.data;
+      uint32_t variant_index;
+      varuint32_from_bin(variant_index, stream);
+      check(variant_index == 1, "replay file message is not a get_blocks_result_v0");
+      from_bin(msg.result, stream);
+   }
+
+   void build_index() {
+      auto     entries = std::move(index.entries);
+      uint64_t first   = entries.size();
+      uint64_t offset  = index.file_size;
+      advise(offset, size, MADV_SEQUENTIAL);
+      while (size - offset >= 4) {
+         uint32_t msg_size;
+         memcpy(&msg_size, data + offset, sizeof(msg_size));
+         if (size - offset - 4 < msg_size)
+            break; // partially written message
+         // only the fixed part of the header is needed
+         input_stream                        stream{ data + offset + 4, msg_size };
+         uint32_t                            variant_index;
+         ship_protocol::get_blocks_result_base header;
+         varuint32_from_bin(variant_index, stream);
+         check(variant_index == 1, "replay file message is not a get_blocks_result_v0");
+         from_bin(header, stream);
+         if (header.this_block)
+            entries.push_back({ header.this_block->block_num, offset });
+         offset += 4 + msg_size;
+      }
+      advise(index.file_size, size, MADV_NORMAL);
+
+      // keep the last copy of each block_num
+      std::stable_sort(entries.begin() + first, entries.end(),
+                       [](auto& a, auto& b) { return a.block_num < b.block_num; });
+      std::inplace_merge(entries.begin(), entries.begin() + first, entries.end(),
+                         [](auto& a, auto& b) { return a.block_num < b.block_num; });
+      auto last = std::unique(entries.rbegin(), entries.rend(),
+                              [](auto& a, auto& b) { return a.block_num == b.block_num; });
+      entries.erase(entries.begin(), last.base());
+      index.entries   = std::move(entries);
+      index.file_size = offset;
+   }
+
+   bool load_index() {
+      try {
+         ship_replay_index loaded;
+         if (!detail::load_replay_side_file(path + ".index", loaded) || loaded.version != index_version ||
+             loaded.file_size > size)
+            return false;
+         index = std::move(loaded);
+         return true;
+      } catch (std::exception&) { return false; }
+   }
+
+   void save_index() const { detail::save_replay_side_file(path + ".index", index); }
+};
+
+} // namespace alaio
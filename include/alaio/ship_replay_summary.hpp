@@ -0,0 +1,206 @@
+#pragma once
+
+#include "ship_replay.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace alaio {
+
+/**
+ * A bloom filter of the names a block mentions: the receiver, act.account and act.name of every action trace, and the
+ * code of every contract_table/contract_row/contract_index* delta row.
+ */
+struct ship_replay_summary_entry {
+   uint32_t block_num  = {};
+   uint64_t offset     = {}; // of the message the filter was built from
+   uint32_t first_word = {};
+   uint32_t num_words  = {}; // a power of 2; 0 when the block mentions no names
+};
+
+ALAIO_REFLECT(ship_replay_summary_entry, block_num, offset, first_word, num_words)
+
+// Stored next to a replay file as `<path>.summary`
+struct ship_replay_summary_data {
+   uint32_t                               version = 1;
+   std::vector<ship_replay_summary_entry> entries = {};
+   std::vector<uint64_t>                  words   = {};
+};
+
+ALAIO_REFLECT(ship_replay_summary_data, version, entries, words)
+
+namespace detail {
+   inline constexpr int summary_hashes        = 4;
+   inline constexpr int summary_bits_per_name = 12;
+
+   inline uint64_t summary_hash(uint64_t v) {
+      v = (v ^ (v >> 30)) * 0xbf58476d1ce4e5b9ull;
+      v = (v ^ (v >> 27)) * 0x94d049bb133111ebull;
+      return v ^ (v >> 31);
+   }
+
+   template <typename F>
+   void for_each_summary_bit(uint32_t num_words, uint64_t value, F f) {
+      uint64_t h    = summary_hash(value);
+      uint64_t h1   = h & 0xffff'ffff;
+      uint64_t h2   = (h >> 32) | 1;
+      uint64_t mask = uint64_t(num_words) * 64 - 1;
+      for (int i = 0; i < summary_hashes; ++i) f((h1 + i * h2) & mask);
+   }
+
+   inline void add_summary_names(const ship_protocol::transaction_trace& trace, std::vector<uint64_t>& names) {
+      auto& t = std::get<ship_protocol::transaction_trace_v0>(trace);
+      for (auto& at : t.action_traces) {
+         std::visit(
+               [&](auto& a) {
+                  names.push_back(a.receiver.value);
+                  names.push_back(a.act.account.value);
+                  names.push_back(a.act.name.value);
+               },
+               at);
+      }
+      for (auto& failed : t.failed_dtrx_trace) add_summary_names(failed.recurse, names);
+   }
+} // namespace detail
+
+// Sorted, distinct names a block mentions
+inline std::vector<uint64_t> ship_block_names(const ship_protocol::get_blocks_result_v0& result) {
+   std::vector<uint64_t> names;
+   if (result.traces && result.traces->remaining()) {
+      auto                                          stream = *result.traces;
+      std::vector<ship_protocol::transaction_trace> traces;
+      from_bin(traces, stream);
+      for (auto& trace : traces) detail::add_summary_names(trace, names);
+   }
+   if (result.deltas && result.deltas->remaining()) {
+      auto                                    stream = *result.deltas;
+      std::vector<ship_protocol::table_delta> deltas;
+      from_bin(deltas, stream);
+      for (auto& delta : deltas) {
+         auto& d = std::get<ship_protocol::table_delta_v0>(delta);
+         if (d.name != "contract_table" && d.name != "contract_row" && d.name.rfind("contract_index", 0) != 0)
+            continue;
+         // every contract_* row starts with code
+         for (auto& row : d.rows) {
+            auto     row_stream = row.data;
+            uint32_t variant_index;
+            name     code;
+            varuint32_from_bin(variant_index, row_stream);
+            from_bin(code, row_stream);
+            names.push_back(code.value);
+         }
+      }
+   }
+   std::sort(names.begin(), names.end());
+   names.erase(std::unique(names.begin(), names.end()), names.end());
+   return names;
+}
+
+/**
+ * Per-block name filters for a replay file, used to skip blocks which can not involve a set of accounts without
+ * decoding their traces or deltas. Filters have no false negatives; about 1% of uninvolved blocks still match.
+ */
+class ship_replay_summary {
+ public:
+   static constexpr uint32_t summary_version = 1;
+
+   // Loads `<path>.summary`, summarizes the blocks it does not cover or which a fork replaced, and rewrites it when it
+   // changed
+   explicit ship_replay_summary(const ship_replay_file& file, bool use_summary_file = true) {
+      auto                     path = file.get_path() + ".summary";
+      ship_replay_summary_data old;
+      try {
+         if (!use_summary_file || !detail::load_replay_side_file(path, old) || old.version != summary_version)
+            old = {};
+      } catch (std::exception&) { old = {}; }
+
+      bool changed = old.entries.size() != file.entries().size();
+      for (std::size_t i = 0; i < file.entries().size(); ++i) {
+         auto& e  = file.entries()[i];
+         auto  it = std::lower_bound(old.entries.begin(), old.entries.end(), e.block_num,
+                                    [](auto& s, uint32_t b) { return s.block_num < b; });
+         ship_replay_summary_entry entry{ e.block_num, e.offset, uint32_t(data.words.size()), 0 };
+         if (it != old.entries.end() && it->block_num == e.block_num && it->offset == e.offset &&
+             uint64_t(it->first_word) + it->num_words <= old.words.size()) {
+            entry.num_words = it->num_words;
+            data.words.insert(data.words.end(), old.words.begin() + it->first_word,
+                              old.words.begin() + it->first_word + it->num_words);
+         } else {
+            changed    = true;
+            auto names = ship_block_names(file.get(i).result);
+            if (!names.empty()) {
+               uint32_t bits = names.size() * detail::summary_bits_per_name;
+               entry.num_words = 1;
+               while (entry.num_words * 64 < bits) entry.num_words *= 2;
+               data.words.resize(data.words.size() + entry.num_words);
+               for (auto n : names) add(entry, n);
+            }
+         }
+         data.entries.push_back(entry);
+      }
+      if (use_summary_file && changed)
+         detail::save_replay_side_file(path, data);
+   }
+
+   const ship_replay_summary_data& get_data() const { return data; }
+
+   // False only if block_num was summarized and does not mention n
+   bool may_contain(uint32_t block_num, name n) const { return may_contain_any(block_num, &n, &n + 1); }
+
+   bool may_contain_any(uint32_t block_num, const std::vector<name>& names) const {
+      return may_contain_any(block_num, names.data(), names.data() + names.size());
+   }
+
+   // Calls f(const ship_replay_message&) for every block in [first_block, end_block) which may mention one of names
+   template <typename F>
+   void for_each(const ship_replay_file& file, uint32_t first_block, uint32_t end_block,
+                 const std::vector<name>& names, F&& f) const {
+      auto& entries = file.entries();
+      for (auto i = file.lower_bound(first_block); i < entries.size() && entries[i].block_num < end_block; ++i) {
+         auto* entry = find(entries[i].block_num);
+         if (entry && entry->offset == entries[i].offset &&
+             !matches_any(*entry, names.data(), names.data() + names.size()))
+            continue;
+         f(file.get(i));
+      }
+   }
+
+ private:
+   ship_replay_summary_data data;
+
+   const ship_replay_summary_entry* find(uint32_t block_num) const {
+      auto it = std::lower_bound(data.entries.begin(), data.entries.end(), block_num,
+                                 [](auto& s, uint32_t b) { return s.block_num < b; });
+      if (it == data.entries.end() || it->block_num != block_num)
+         return nullptr;
+      return &*it;
+   }
+
+   void add(const ship_replay_summary_entry& entry, uint64_t value) {
+      auto* words = data.words.data() + entry.first_word;
+      detail::for_each_summary_bit(entry.num_words, value,
+                                   [&](uint64_t bit) { words[bit / 64] |= uint64_t(1) << (bit % 64); });
+   }
+
+   bool matches_any(const ship_replay_summary_entry& entry, const name* begin, const name* end) const {
+      if (!entry.num_words)
+         return false;
+      auto* words = data.words.data() + entry.first_word;
+      for (auto* n = begin; n != end; ++n) {
+         bool found = true;
+         detail::for_each_summary_bit(entry.num_words, n->value, [&](uint64_t bit) {
+            found = found && (words[bit / 64] & (uint64_t(1) << (bit % 64)));
+         });
+         if (found)
+            return true;
+      }
+      return false;
+   }
+
+   bool may_contain_any(uint32_t block_num, const name* begin, const name* end) const {
+      auto* entry = find(block_num);
+      return !entry || matches_any(*entry, begin, end);
+   }
+};
+
+} // namespace alaio
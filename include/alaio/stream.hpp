@@ -1,10 +1,14 @@
 #pragma once
 
 #include "check.hpp"
+#include "json_dictionary.hpp"
+#include "reflection.hpp"
+#include <array>
 #include <string>
 #include <string_view>
 #include <vector>
 #include <type_traits>
+#include <utility>
 #include <string.h>
 #include <algorithm>
 #include <system_error>
@@ -50,6 +54,65 @@ constexpr inline std::string_view convert_stream_error(stream_error e) {
    }
 }
 
+// Reflected types whose serialization differs from their in-memory layout declare an overload returning true, which
+// keeps them from being treated as bitwise.
+constexpr bool has_custom_serialization(const void*) { return false; }
+
+// Types which serialize as another type declare serialize_as(const T&) returning it
+void serialize_as(...);
+
+template <typename T>
+using serialization_type = decltype(serialize_as(std::declval<T>()));
+
+template <typename T>
+constexpr bool has_bitwise_serialization();
+
+namespace detail {
+   template <typename T, typename = void>
+   struct is_constexpr_default_constructible : std::false_type {};
+
+   template <typename T>
+   struct is_constexpr_default_constructible<T, std::enable_if_t<(void(T{}), true)>> : std::true_type {};
+
+   template <typename T>
+   struct is_std_array : std::false_type {};
+
+   template <typename T, std::size_t N>
+   struct is_std_array<std::array<T, N>> : std::true_type {};
+
+   // True when the reflected fields are bitwise, listed in declaration order, and exactly fill T, so that the wire
+   // format is T's memory image. Needs a constexpr default constructor to compare field addresses.
+   template <typename T>
+   constexpr bool reflected_fields_fill_object() {
+      if constexpr (!std::is_trivially_copyable_v<T> || !std::is_standard_layout_v<T> ||
+                    !is_constexpr_default_constructible<T>::value) {
+         return false;
+      } else {
+         T           obj{};
+         const void* prev = nullptr;
+         std::size_t size = 0;
+         bool        ok   = true;
+         alaio_for_each_field((T*)nullptr, [&](const char*, auto member) {
+            using M = decltype(member((T*)nullptr));
+            if constexpr (std::is_member_object_pointer_v<M>) {
+               using F = reflection::member_object_type_t<M>;
+               if constexpr (has_bitwise_serialization<F>()) {
+                  const void* p = &(obj.*member((T*)nullptr));
+                  ok            = ok && (!prev || prev < p);
+                  prev          = p;
+                  size += sizeof(F);
+               } else {
+                  ok = false;
+               }
+            }
+         });
+         return ok && size == sizeof(T);
+      }
+   }
+} // namespace detail
+
+// Types whose serialized form is their little-endian memory image. Vectors and arrays of them are read and written
+// with a single copy.
 template<typename T>
 constexpr bool has_bitwise_serialization() {
    if constexpr (std::is_arithmetic_v<T> 
@@ -61,6 +124,11 @@ constexpr bool has_bitwise_serialization() {
    } else if constexpr (std::is_enum_v<T>) {
       static_assert(!std::is_convertible_v<T, std::underlying_type_t<T>>, "Serializing unscoped enum");
       return true;
+   } else if constexpr (detail::is_std_array<T>::value) {
+      return has_bitwise_serialization<typename T::value_type>();
+   } else if constexpr (reflection::has_for_each_field_v<T>) {
+      return !has_custom_serialization((T*)nullptr) && std::is_same_v<serialization_type<T>, void> &&
+             detail::reflected_fields_fill_object<T>();
    } else {
       return false;
    }
@@ -91,6 +159,24 @@ struct vector_stream {
    }
 };
 
+// Appends to a std::string, which grows geometrically, so output can be written in one pass without measuring first
+struct string_stream {
+   std::string&     data;
+   json_dictionary* dictionary = get_json_dictionary(); // installed when the stream was created
+   string_stream(std::string& data) : data(data) {}
+
+   void write(char c) {
+      data.push_back(c);
+   }
+   void write(const void* src, std::size_t sz) {
+      data.append(reinterpret_cast<const char*>(src), sz);
+   }
+   template <typename T>
+   void write_raw(const T& v) {
+      write(&v, sizeof(v));
+   }
+};
+
 struct fixed_buf_stream {
    char* pos;
    char* end;
@@ -158,6 +244,12 @@ template <typename S>
 void write_newline(S&) {
 }
 
+// Writes an object key; key is pre-escaped JSON of the form ,"name": and the comma is dropped for the first key
+template <typename S>
+void write_key(std::string_view key, bool first, S& s) {
+   s.write(key.data() + first, key.size() - first);
+}
+
 template <typename Base>
 struct pretty_stream : Base {
    using Base::Base;
@@ -172,7 +264,7 @@ void increase_indent(pretty_stream<S>& s) {
 
 template <typename S>
 void decrease_indent(pretty_stream<S>& s) {
-   check( s.current_indent.size() >= s.indent_size,
+   check( s.current_indent.size() >= std::size_t(s.indent_size),
          convert_stream_error(stream_error::overrun) );
    s.current_indent.resize(s.current_indent.size() - s.indent_size);
 }
@@ -188,6 +280,15 @@ void write_newline(pretty_stream<S>& s) {
    s.write(s.current_indent.data(), s.current_indent.size());
 }
 
+template <typename S>
+void write_key(std::string_view key, bool first, pretty_stream<S>& s) {
+   if (!first)
+      s.write(',');
+   write_newline(s);
+   s.write(key.data() + 1, key.size() - 2);
+   write_colon(s);
+}
+
 struct input_stream {
    const char* pos;
    const char* end;
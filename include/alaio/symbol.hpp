@@ -167,8 +167,36 @@ class symbol_code {
 ALAIO_REFLECT(symbol_code, value);
 ALAIO_COMPARE(symbol_code);
 
+// True if no character of the symbol code needs escaping in JSON
+inline bool symbol_code_is_json_safe(uint64_t v) {
+   for (; v; v >>= 8) {
+      char c = char(v & 0xff);
+      if (c < 0x20 || c == '"' || c == '\\' || c == 0x7f)
+         return false;
+   }
+   return true;
+}
+
+// Quotes chars..end into dest
+inline char* symbol_chars_to_json(char* dest, const char* chars, const char* end) {
+   *dest++ = '"';
+   memcpy(dest, chars, end - chars);
+   dest += end - chars;
+   *dest++ = '"';
+   return dest;
+}
+
 template <typename S>
 void to_json(const symbol_code& obj, S& stream) {
+   if (auto* dictionary = get_json_dictionary(stream)) {
+      if (symbol_code_is_json_safe(obj.value)) {
+         dictionary->write(json_dictionary::kind::symbol_code, obj.value, stream, [&](char* dest) {
+            char buf[8];
+            return symbol_chars_to_json(dest, buf, symbol_code_to_chars(obj.value, buf));
+         });
+         return;
+      }
+   }
    to_json(symbol_code_to_string(obj.value), stream);
 }
 
@@ -247,6 +275,15 @@ ALAIO_COMPARE(symbol);
 
 template <typename S>
 void to_json(const symbol& obj, S& stream) {
+   if (auto* dictionary = get_json_dictionary(stream)) {
+      if (symbol_code_is_json_safe(obj.value >> 8)) {
+         dictionary->write(json_dictionary::kind::symbol, obj.value, stream, [&](char* dest) {
+            char buf[12];
+            return symbol_chars_to_json(dest, buf, symbol_to_chars(obj.value, buf));
+         });
+         return;
+      }
+   }
    to_json(symbol_to_string(obj.value), stream);
 }
 
@@ -97,9 +97,19 @@ void from_json(time_point& obj, S& stream) {
    obj = time_point(microseconds(utc_microseconds));
 }
 
+// Writes a quoted time; the characters never need escaping
+template <typename S>
+void utc_microseconds_to_json(uint64_t microseconds, S& stream) {
+   char buf[utc_time_size + 2];
+   buf[0]                 = '"';
+   buf[utc_time_size + 1] = '"';
+   microseconds_to_chars(microseconds, buf + 1);
+   stream.write(buf, sizeof(buf));
+}
+
 template <typename S>
 void to_json(const time_point& obj, S& stream) {
-   return to_json(alaio::microseconds_to_str(obj.elapsed._count), stream);
+   utc_microseconds_to_json(obj.elapsed._count, stream);
 }
 
 /**
@@ -178,7 +188,7 @@ void from_json(time_point_sec& obj, S& stream) {
 
 template <typename S>
 void to_json(const time_point_sec& obj, S& stream) {
-   return to_json(alaio::microseconds_to_str(uint64_t(obj.utc_seconds) * 1'000'000), stream);
+   utc_microseconds_to_json(uint64_t(obj.utc_seconds) * 1'000'000, stream);
 }
 
 /**
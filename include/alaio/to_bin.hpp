@@ -60,6 +60,11 @@ void to_bin(const std::string& s, S& stream) {
    to_bin(std::string_view{ s }, stream);
 }
 
+template <typename A, typename S>
+void to_bin(const std::basic_string<char, std::char_traits<char>, A>& s, S& stream) {
+   to_bin(std::string_view{ s }, stream);
+}
+
 template <typename T, typename S>
 void to_bin_range(const T& obj, S& stream) {
    varuint32_to_bin(obj.size(), stream);
@@ -80,8 +85,8 @@ void to_bin(const T (&obj)[N], S& stream) {
    }
 }
 
-template <typename T, typename S>
-void to_bin(const std::vector<T>& obj, S& stream) {
+template <typename T, typename A, typename S>
+void to_bin(const std::vector<T, A>& obj, S& stream) {
    varuint32_to_bin(obj.size(), stream);
    if constexpr (has_bitwise_serialization<T>()) {
       stream.write(reinterpret_cast<const char*>(obj.data()), obj.size() * sizeof(T));
@@ -2,7 +2,7 @@
 
 #include <cmath>
 #include "for_each_field.hpp"
-#include "fpconv.h"
+#include "number_format.hpp"
 #include "stream.hpp"
 #include "types.hpp"
 #include <limits>
@@ -68,6 +68,11 @@ void to_json(const std::string& s, S& stream) {
    to_json(std::string_view{ s }, stream);
 }
 
+template <typename A, typename S>
+void to_json(const std::basic_string<char, std::char_traits<char>, A>& s, S& stream) {
+   to_json(std::string_view{ s }, stream);
+}
+
 template <typename S>
 void to_json(const char* s, S& stream) {
    to_json(std::string_view{ s }, stream);
@@ -88,44 +93,6 @@ void to_json(bool value, S& stream) {
       stream.write("false", 5);
 }
 
-template <typename T>
-struct make_unsigned : std::make_unsigned<T> {};
-
-#ifndef ABIALA_NO_INT128
-// some standard library does not support std::make_unsigned<__int128> yet. 
-template <>
-struct make_unsigned<__int128> {
-   using type = unsigned __int128;
-};
-
-template <>
-struct make_unsigned<unsigned __int128> {
-   using type = unsigned __int128;
-};
-#endif
-
-template <typename T>
-using make_unsigned_t = typename make_unsigned<T>::type;
-
-template <typename T>
-char* int_to_decimal(T value, char* buffer) {
-   char* pos = buffer;
-   auto uvalue = make_unsigned_t<T>(value);
-   bool neg    = value < 0;
-   if (neg)
-      uvalue = -uvalue;
-   
-   do {
-      *pos++ = '0' + (uvalue % 10);
-      uvalue /= 10;
-   } while (uvalue);
-
-   if (neg)
-      *pos++ = '-';
-   std::reverse(buffer, pos);
-   return pos;
-}
-
 template <typename T, typename S>
 void int_to_json(T value, S& stream) {
    // For older versions of libstdc++ (g++ version 9 and below) std::numeric_limits<__int128>::digits10 
@@ -140,20 +107,19 @@ void int_to_json(T value, S& stream) {
    stream.write(b.data, b.pos - b.data);
 }
 
-template <typename S>
-void fp_to_json(double value, S& stream) {
-   // fpconv is not quite consistent with javascript for nans and infinities
-   if (value == std::numeric_limits<double>::infinity()) {
+template <typename T, typename S>
+void fp_to_json(T value, S& stream) {
+   // JSON has no nans or infinities; write them the way javascript names them
+   if (value == std::numeric_limits<T>::infinity()) {
       stream.write("\"Infinity\"", 10);
-   } else if (value == -std::numeric_limits<double>::infinity()) {
+   } else if (value == -std::numeric_limits<T>::infinity()) {
       stream.write("\"-Infinity\"", 11);
    } else if (std::isnan(value)) {
       stream.write("\"NaN\"", 5);
    } else {
-      small_buffer<24> b; // fpconv_dtoa generates at most 24 characters
-      int              n = fpconv_dtoa(value, b.pos);
-      check( n > 0, convert_stream_error(stream_error::float_error) );
-      b.pos += n;
+      small_buffer<25> b;
+      b.pos = float_to_shortest(value, b.pos);
+      check( b.pos > b.data, convert_stream_error(stream_error::float_error) );
       stream.write(b.data, b.pos - b.data);
    }
 }
@@ -178,8 +144,8 @@ template <typename S> void to_json(__int128 value, S& stream) { return int_to_js
 
 // clang-format on
 
-template <typename T, typename S>
-void to_json(const std::vector<T>& obj, S& stream) {
+template <typename T, typename A, typename S>
+void to_json(const std::vector<T, A>& obj, S& stream) {
    stream.write('[');
    bool first = true;
    for (auto& v : obj) {
@@ -254,25 +220,89 @@ void to_json(const std::variant<T...>& obj, S& stream) {
       using value_type = T;
    };
 
+/// \exclude
+/// Keys of T's reflected fields, escaped at compile time. Each is stored as ,"name": so that writing one is a single
+/// write() in the compact format.
+template <typename T>
+struct json_keys {
+   static constexpr bool needs_escape(char c) { return c == '"' || c == '\\' || (unsigned char)c < 32 || c == 127; }
+
+   static constexpr std::size_t escaped_size(const char* name) {
+      std::size_t result = 0;
+      for (; *name; ++name) result += needs_escape(*name) ? (*name == '"' || *name == '\\' ? 2 : 6) : 1;
+      return result;
+   }
+
+   static constexpr std::size_t total_size() {
+      std::size_t result = 0;
+      alaio_for_each_field((T*)nullptr, [&](const char* name, auto member) {
+         if constexpr (std::is_member_object_pointer_v<decltype(member((T*)nullptr))>)
+            result += escaped_size(name) + 4;
+      });
+      return result;
+   }
+
+   static constexpr std::size_t num_fields = reflection::num_fields<T>();
+
+   struct table {
+      char        data[total_size() + 1] = {};
+      std::size_t offsets[num_fields + 1] = {};
+   };
+
+   static constexpr table make_table() {
+      table       result{};
+      std::size_t pos = 0, i = 0;
+      alaio_for_each_field((T*)nullptr, [&](const char* name, auto member) {
+         if constexpr (std::is_member_object_pointer_v<decltype(member((T*)nullptr))>) {
+            result.offsets[i++] = pos;
+            result.data[pos++]  = ',';
+            result.data[pos++] = '"';
+            for (; *name; ++name) {
+               char c = *name;
+               if (c == '"' || c == '\\') {
+                  result.data[pos++] = '\\';
+                  result.data[pos++] = c;
+               } else if (needs_escape(c)) {
+                  result.data[pos++] = '\\';
+                  result.data[pos++] = 'u';
+                  result.data[pos++] = '0';
+                  result.data[pos++] = '0';
+                  result.data[pos++] = hex_digits[(unsigned char)c >> 4];
+                  result.data[pos++] = hex_digits[(unsigned char)c & 15];
+               } else {
+                  result.data[pos++] = c;
+               }
+            }
+            result.data[pos++] = '"';
+            result.data[pos++] = ':';
+         }
+      });
+      result.offsets[i] = pos;
+      return result;
+   }
+
+   static constexpr table keys = make_table();
+
+   static std::string_view get(std::size_t i) {
+      return { keys.data + keys.offsets[i], keys.offsets[i + 1] - keys.offsets[i] };
+   }
+};
+
 template <typename T, typename S>
 void to_json(const T& t, S& stream) {
    bool         first = true;
+   std::size_t  i     = 0;
    stream.write('{');
-   alaio::for_each_field<T>([&](const char* name, auto&& member) {
+   alaio::for_each_field<T>([&](const char*, auto&& member) {
        auto addfield = [&]() {
-         if (first) {
+         if (first)
             increase_indent(stream);
-            first = false;
-         } else {
-            stream.write(',');
-         }
-         write_newline(stream);
-         to_json(name, stream);
-         write_colon(stream);
+         write_key(json_keys<T>::get(i), first, stream);
+         first = false;
          to_json(member(&t), stream);
       };
 
-      auto m = member(&t);
+      const auto& m = member(&t);
       using member_type = std::decay_t<decltype(m)>;
       if constexpr ( not is_std_optional<member_type>::value ) {
          addfield();
@@ -282,6 +312,7 @@ void to_json(const T& t, S& stream) {
          if( !!m || true )
             addfield();
       }
+      ++i;
    });
    if (!first) {
       decrease_indent(stream);
@@ -311,23 +342,17 @@ template <typename S> void to_json(long double value, S& stream) {
 
 template <typename T>
 std::string convert_to_json(const T& t) {
-   size_stream ss;
-   to_json(t, ss);
-   std::string      result(ss.size, 0);
-   fixed_buf_stream fbs(result.data(), result.size());
-   to_json(t, fbs);
-   check( fbs.pos == fbs.end, convert_stream_error(stream_error::underrun) );
+   std::string   result;
+   string_stream stream(result);
+   to_json(t, stream);
    return result;
 }
 
 template <typename T>
 std::string format_json(const T& t) {
-   pretty_stream<size_stream> ss;
-   to_json(t, ss);
-   std::string                     result(ss.size, 0);
-   pretty_stream<fixed_buf_stream> fbs(result.data(), result.size());
-   to_json(t, fbs);
-   check( fbs.pos == fbs.end, convert_stream_error(stream_error::underrun) );
+   std::string                  result;
+   pretty_stream<string_stream> stream(result);
+   to_json(t, stream);
    return result;
 }
 
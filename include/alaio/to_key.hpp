@@ -73,7 +73,7 @@ void to_key_optional(const bool* obj, S& stream) {
 
 template <typename T, typename S>
 void to_key_optional(const T* obj, S& stream) {
-   if constexpr (has_bitwise_serialization<T>() && sizeof(T) == 1) {
+   if constexpr ((std::is_arithmetic_v<T> || std::is_enum_v<T>) && sizeof(T) == 1) {
       if (obj == nullptr)
          stream.write("\0", 2);
       else {
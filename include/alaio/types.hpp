@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -21,6 +22,7 @@ constexpr const char* get_type_name(std::uint64_t*) { return "uint64"; }
 constexpr const char* get_type_name(float*) { return "float32"; }
 constexpr const char* get_type_name(double*) { return "float64"; }
 constexpr const char* get_type_name(std::string*) { return "string"; }
+constexpr const char* get_type_name(std::string_view*) { return "string"; }
 
 #ifndef ABIALA_NO_INT128
 constexpr const char* get_type_name(__int128*) { return "int128"; }
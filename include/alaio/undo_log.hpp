@@ -0,0 +1,154 @@
+#pragma once
+
+#include "bytes_btree.hpp"
+#include "check.hpp"
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace alaio {
+
+/**
+ * Bump allocator. Memory is released all at once by reset(), which keeps the first chunk for reuse.
+ */
+class monotonic_arena {
+ public:
+   static constexpr std::size_t chunk_size = 64 * 1024;
+
+   monotonic_arena() = default;
+   monotonic_arena(monotonic_arena&& other) { *this = std::move(other); }
+
+   monotonic_arena& operator=(monotonic_arena&& other) {
+      chunks    = std::move(other.chunks);
+      pos       = std::exchange(other.pos, nullptr);
+      remaining = std::exchange(other.remaining, 0);
+      return *this;
+   }
+
+   void* allocate(std::size_t size) {
+      size = (size + 7) & ~std::size_t(7);
+      if (remaining < size) {
+         auto bytes = std::max(size, chunk_size);
+         chunks.emplace_back(new char[bytes]);
+         pos       = chunks.back().get();
+         remaining = bytes;
+      }
+      void* p = pos;
+      pos += size;
+      remaining -= size;
+      return p;
+   }
+
+   void reset() {
+      if (chunks.empty())
+         return;
+      chunks.resize(1);
+      pos       = chunks[0].get();
+      remaining = chunk_size;
+   }
+
+ private:
+   std::vector<std::unique_ptr<char[]>> chunks;
+   char*                                pos       = nullptr;
+   std::size_t                          remaining = 0;
+};
+
+/**
+ * Per-block record of the previous contents of changed bytes_btree keys. Reverting replays the records newest first,
+ * so it costs one tree operation per recorded change. Each block's records live in that block's arena.
+ */
+class undo_log {
+ public:
+   // Starts recording for block_num, which must be above every block already recorded
+   void start_block(uint32_t block_num) {
+      check(blocks.empty() || blocks.back().block_num < block_num, "undo_log blocks must be started in order");
+      blocks.push_back({ block_num, take_arena() });
+   }
+
+   // Records the current state of key in the latest block; does nothing when no block is being recorded
+   void record(const bytes_btree& tree, std::string_view key) {
+      if (blocks.empty())
+         return;
+      auto&       b     = blocks.back();
+      auto*       old   = tree.find(key);
+      std::size_t size  = sizeof(entry) + key.size() + (old ? old->value_size : 0);
+      auto*       e     = static_cast<entry*>(b.arena.allocate(size));
+      e->prev           = b.last;
+      e->key_size       = key.size();
+      e->value_size     = old ? old->value_size : absent;
+      auto* data        = reinterpret_cast<char*>(e + 1);
+      memcpy(data, key.data(), key.size());
+      if (old)
+         memcpy(data + key.size(), old->value().data(), old->value_size);
+      b.last = e;
+   }
+
+   // Restores tree to its state before the first block >= block_num and forgets those blocks
+   void revert(bytes_btree& tree, uint32_t block_num) {
+      while (!blocks.empty() && blocks.back().block_num >= block_num) {
+         auto& b = blocks.back();
+         for (auto* e = b.last; e; e = e->prev) {
+            auto*            data = reinterpret_cast<const char*>(e + 1);
+            std::string_view key{ data, e->key_size };
+            if (e->value_size == absent)
+               tree.erase(key);
+            else
+               tree.put(key, { data + e->key_size, e->value_size });
+         }
+         release_arena(std::move(b.arena));
+         blocks.pop_back();
+      }
+   }
+
+   // Forgets blocks <= block_num; they can no longer be reverted
+   void commit(uint32_t block_num) {
+      while (!blocks.empty() && blocks.front().block_num <= block_num) {
+         release_arena(std::move(blocks.front().arena));
+         blocks.pop_front();
+      }
+   }
+
+   std::size_t             num_blocks() const { return blocks.size(); }
+   std::optional<uint32_t> last_block() const {
+      if (blocks.empty())
+         return {};
+      return blocks.back().block_num;
+   }
+
+ private:
+   static constexpr uint32_t absent = 0xffff'ffff;
+
+   struct entry {
+      entry*   prev;
+      uint32_t key_size;
+      uint32_t value_size;
+   };
+
+   struct block {
+      uint32_t        block_num;
+      monotonic_arena arena;
+      entry*          last = nullptr;
+   };
+
+   std::deque<block>            blocks;
+   std::vector<monotonic_arena> spare_arenas;
+
+   monotonic_arena take_arena() {
+      if (spare_arenas.empty())
+         return {};
+      auto a = std::move(spare_arenas.back());
+      spare_arenas.pop_back();
+      return a;
+   }
+
+   void release_arena(monotonic_arena&& a) {
+      a.reset();
+      if (spare_arenas.size() < 16)
+         spare_arenas.push_back(std::move(a));
+   }
+};
+
+} // namespace alaio
@@ -203,6 +203,7 @@ struct unsigned_int {
 
 using varuint32 = unsigned_int;
 ALAIO_REFLECT(varuint32, value);
+constexpr bool has_custom_serialization(varuint32*) { return true; }
 
 template <typename F>
 void convert(const varuint32& src, uint32_t& dst, F&& chooser) {
@@ -214,6 +215,22 @@ void from_bin(varuint32& obj, S& stream) {
    return varuint32_from_bin(obj.value, stream);
 }
 
+template <typename S>
+void skip_bin(varuint32*, S& stream) {
+   uint32_t value;
+   varuint32_from_bin(value, stream);
+}
+
+template <typename A, typename S>
+void from_bin(std::vector<varuint32, A>& v, S& stream) {
+   uint32_t size;
+   varuint32_from_bin(size, stream);
+   // each element takes at least one byte
+   stream.check_available(size);
+   v.resize(size);
+   varuint32s_from_bin(v.begin(), size, stream);
+}
+
 template <typename S>
 void to_bin(const varuint32& obj, S& stream) {
    return varuint32_to_bin(obj.value, stream);
@@ -423,12 +440,19 @@ struct signed_int {
 
 using varint32 = signed_int;
 ALAIO_REFLECT(varint32, value);
+constexpr bool has_custom_serialization(varint32*) { return true; }
 
 template <typename S>
 void from_bin(varint32& obj, S& stream) {
    return varint32_from_bin(obj.value, stream);
 }
 
+template <typename S>
+void skip_bin(varint32*, S& stream) {
+   uint32_t value;
+   varuint32_from_bin(value, stream);
+}
+
 template <typename S>
 void to_bin(const varint32& obj, S& stream) {
    return varuint32_to_bin((uint32_t(obj.value) << 1) ^ uint32_t(obj.value >> 31), stream);
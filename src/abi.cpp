@@ -24,6 +24,9 @@ struct abi_serializer_impl : abi_serializer {
                              bool start) const override {
         return ::abiala::bin_to_json((T*)nullptr, state, allow_extensions, type, start);
     }
+    void skip_bin(input_stream& bin, bool allow_extensions, const abi_type* type, int depth) const override {
+        return ::abiala::skip_bin((T*)nullptr, bin, allow_extensions, type, depth);
+    }
 };
 
 template <typename T>
@@ -254,6 +257,18 @@ std::vector<char> alaio::abi_type::json_to_bin_reorderable(std::string_view json
    return result;
 }
 
+void alaio::abi_type::skip_bin(input_stream& bin) const {
+   abiala::skip_bin(bin, true, this, 0);
+}
+
+alaio::bin_array_index alaio::abi_type::index_array(input_stream& bin) const {
+   auto element = array_of();
+   check(element, "index_array needs an array type");
+   uint32_t size;
+   varuint32_from_bin(size, bin);
+   return { size, bin, [element](input_stream& s) { abiala::skip_bin(s, false, element, 0); } };
+}
+
 std::vector<char> alaio::abi_type::json_to_bin(std::string_view json, std::function<void()> f) const {
    std::vector<char> result;
    abiala::json_to_bin(result, this, json, f);
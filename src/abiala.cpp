@@ -3,10 +3,31 @@
 #include "abiala.h"
 #include "abiala.hpp"
 
+#include <limits>
 #include <memory>
+#include <unordered_map>
 
 using namespace abiala;
 
+// A compiled abi shared by every (contract, block_num) entry whose abi has the same canonical binary form. When the
+// context is over its memory limit the compiled form is dropped; it is rebuilt from `bin` on the next lookup.
+struct abi_version {
+    std::vector<char> bin{};
+    std::unique_ptr<abi> compiled{};
+    size_t compiled_size = 0;
+    uint64_t last_used = 0;
+};
+
+struct abi_history {
+    // contract -> (first block_num the abi is active at -> abi)
+    std::map<name, std::map<uint32_t, std::shared_ptr<abi_version>>> contracts{};
+    // keys view abi_version::bin
+    std::unordered_map<std::string_view, std::shared_ptr<abi_version>> versions{};
+    size_t memory_limit = std::numeric_limits<size_t>::max();
+    size_t compiled_size = 0;
+    uint64_t clock = 0;
+};
+
 struct abiala_context_s {
     const char* last_error = "";
     std::string last_error_buffer{};
@@ -14,6 +35,8 @@ struct abiala_context_s {
     std::vector<char> result_bin{};
 
     std::map<name, abi> contracts{};
+    abi_history history{};
+    std::unique_ptr<alaio::json_dictionary> json_dictionary{};
 };
 
 void fix_null_str(const char*& s) {
@@ -42,6 +65,87 @@ auto handle_exceptions(abiala_context* context, T errval, F f) noexcept -> declt
     }
 }
 
+size_t approximate_size(const abi& c) {
+    // map nodes are counted as their payload plus a few pointers
+    constexpr size_t node_overhead = 4 * sizeof(void*);
+    size_t result = sizeof(abi);
+    for (auto& [type_name, type] : c.abi_types) {
+        result += node_overhead + sizeof(type_name) + sizeof(type) + type_name.capacity() + type.name.capacity();
+        if (auto* s = type.as_struct())
+            for (auto& f : s->fields)
+                result += sizeof(f) + f.name.capacity();
+        if (auto* v = type.as_variant())
+            for (auto& f : *v)
+                result += sizeof(f) + f.name.capacity();
+    }
+    for (auto* m : {&c.action_types, &c.table_types, &c.action_result_types})
+        for (auto& [_, type_name] : *m)
+            result += node_overhead + sizeof(name) + sizeof(type_name) + type_name.capacity();
+    return result;
+}
+
+// Drops least recently used compiled abis until the history fits its memory limit
+void evict(abi_history& history, const abi_version* keep) {
+    while (history.compiled_size > history.memory_limit) {
+        abi_version* oldest = nullptr;
+        for (auto& [_, v] : history.versions)
+            if (v->compiled && v.get() != keep && (!oldest || v->last_used < oldest->last_used))
+                oldest = v.get();
+        if (!oldest)
+            return;
+        history.compiled_size -= oldest->compiled_size;
+        oldest->compiled.reset();
+    }
+}
+
+abi& compile(abi_history& history, abi_version& v) {
+    v.last_used = ++history.clock;
+    if (!v.compiled) {
+        abi_def def{};
+        alaio::input_stream stream{v.bin.data(), v.bin.size()};
+        from_bin(def, stream);
+        auto c = std::make_unique<abi>();
+        convert(def, *c);
+        v.compiled_size = approximate_size(*c);
+        v.compiled = std::move(c);
+        history.compiled_size += v.compiled_size;
+        evict(history, &v);
+    }
+    return *v.compiled;
+}
+
+void set_abi_at(abi_history& history, name contract, uint32_t block_num, const abi_def& def) {
+    auto bin = convert_to_bin(def);
+    std::shared_ptr<abi_version> v;
+    if (auto it = history.versions.find({bin.data(), bin.size()}); it != history.versions.end()) {
+        v = it->second;
+    } else {
+        v = std::make_shared<abi_version>();
+        v->bin = std::move(bin);
+        compile(history, *v);
+        history.versions.emplace(std::string_view{v->bin.data(), v->bin.size()}, v);
+    }
+    auto& slot = history.contracts[contract][block_num];
+    auto old = std::move(slot);
+    slot = std::move(v);
+    if (old && old.use_count() == 2) {
+        if (old->compiled)
+            history.compiled_size -= old->compiled_size;
+        history.versions.erase({old->bin.data(), old->bin.size()});
+    }
+}
+
+abi& get_abi_at(abi_history& history, name contract, uint32_t block_num) {
+    auto contract_it = history.contracts.find(contract);
+    if (contract_it != history.contracts.end()) {
+        auto it = contract_it->second.upper_bound(block_num);
+        if (it != contract_it->second.begin())
+            return compile(history, *std::prev(it)->second);
+    }
+    throw std::runtime_error("contract \"" + alaio::name_to_string(contract.value) + "\" has no abi at block " +
+                             std::to_string(block_num));
+}
+
 extern "C" abiala_context* abiala_create() {
     try {
         return new abiala_context{};
@@ -238,6 +342,7 @@ extern "C" const char* abiala_bin_to_json(abiala_context* context, uint64_t cont
         }
         auto t = contract_it->second.get_type(type);
         alaio::input_stream bin{data, size};
+        alaio::json_dictionary_scope scope{context->json_dictionary.get()};
         context->result_str = t->bin_to_json(bin);
         if (bin.pos != bin.end)
             throw std::runtime_error("Extra data");
@@ -260,6 +365,144 @@ extern "C" const char* abiala_hex_to_json(abiala_context* context, uint64_t cont
     });
 }
 
+extern "C" abiala_bool abiala_set_abi_at(abiala_context* context, uint64_t contract, uint32_t block_num,
+                                         const char* abi) {
+    fix_null_str(abi);
+    return handle_exceptions(context, false, [&]() {
+        context->last_error = "abi parse error";
+        abi_def def{};
+        std::string error;
+        std::string abi_copy{abi};
+        alaio::json_token_stream stream(abi_copy.data());
+        from_json(def, stream);
+        if (!check_abi_version(def.version, error))
+            return set_error(context, std::move(error));
+        set_abi_at(context->history, name{contract}, block_num, def);
+        return true;
+    });
+}
+
+extern "C" abiala_bool abiala_set_abi_bin_at(abiala_context* context, uint64_t contract, uint32_t block_num,
+                                             const char* data, size_t size) {
+    return handle_exceptions(context, false, [&] {
+        context->last_error = "abi parse error";
+        if (!data || !size)
+            return set_error(context, "no data");
+        std::string error;
+        alaio::input_stream stream{data, size};
+        std::string version;
+        from_bin(version, stream);
+        if (!check_abi_version(version, error))
+            return set_error(context, std::move(error));
+        abi_def def{};
+        stream = {data, size};
+        from_bin(def, stream);
+        set_abi_at(context->history, name{contract}, block_num, def);
+        return true;
+    });
+}
+
+extern "C" abiala_bool abiala_set_abi_hex_at(abiala_context* context, uint64_t contract, uint32_t block_num,
+                                             const char* hex) {
+    fix_null_str(hex);
+    return handle_exceptions(context, false, [&]() -> abiala_bool {
+        std::vector<char> data;
+        std::string error;
+        if (!unhex(error, hex, hex + strlen(hex), std::back_inserter(data))) {
+            if (!error.empty())
+                set_error(context, std::move(error));
+            return false;
+        }
+        return abiala_set_abi_bin_at(context, contract, block_num, data.data(), data.size());
+    });
+}
+
+extern "C" void abiala_set_abi_memory_limit(abiala_context* context, size_t limit) {
+    handle_exceptions(context, false, [&] {
+        context->history.memory_limit = limit;
+        evict(context->history, nullptr);
+        return true;
+    });
+}
+
+extern "C" void abiala_set_json_dictionary(abiala_context* context, size_t capacity) {
+    handle_exceptions(context, false, [&] {
+        context->json_dictionary = capacity ? std::make_unique<alaio::json_dictionary>(capacity) : nullptr;
+        return true;
+    });
+}
+
+extern "C" const char* abiala_get_type_for_action_at(abiala_context* context, uint64_t contract, uint32_t block_num,
+                                                     uint64_t action) {
+    return handle_exceptions(context, nullptr, [&] {
+        auto& c = get_abi_at(context->history, name{contract}, block_num);
+        auto action_it = c.action_types.find(name{action});
+        if (action_it == c.action_types.end())
+            throw std::runtime_error("contract \"" + alaio::name_to_string(contract) + "\" does not have action \"" +
+                                     alaio::name_to_string(action) + "\" at block " + std::to_string(block_num));
+        context->result_str = action_it->second;
+        return context->result_str.c_str();
+    });
+}
+
+extern "C" const char* abiala_get_type_for_table_at(abiala_context* context, uint64_t contract, uint32_t block_num,
+                                                    uint64_t table) {
+    return handle_exceptions(context, nullptr, [&] {
+        auto& c = get_abi_at(context->history, name{contract}, block_num);
+        auto table_it = c.table_types.find(name{table});
+        if (table_it == c.table_types.end())
+            throw std::runtime_error("contract \"" + alaio::name_to_string(contract) + "\" does not have table \"" +
+                                     alaio::name_to_string(table) + "\" at block " + std::to_string(block_num));
+        context->result_str = table_it->second;
+        return context->result_str.c_str();
+    });
+}
+
+extern "C" abiala_bool abiala_json_to_bin_at(abiala_context* context, uint64_t contract, uint32_t block_num,
+                                             const char* type, const char* json) {
+    fix_null_str(type);
+    fix_null_str(json);
+    return handle_exceptions(context, false, [&] {
+        context->last_error = "json parse error";
+        auto t = get_abi_at(context->history, name{contract}, block_num).get_type(type);
+        context->result_bin.clear();
+        context->result_bin = t->json_to_bin(json);
+        return true;
+    });
+}
+
+extern "C" const char* abiala_bin_to_json_at(abiala_context* context, uint64_t contract, uint32_t block_num,
+                                             const char* type, const char* data, size_t size) {
+    fix_null_str(type);
+    return handle_exceptions(context, nullptr, [&]() -> const char* {
+        if (!data)
+            size = 0;
+        context->last_error = "binary decode error";
+        auto t = get_abi_at(context->history, name{contract}, block_num).get_type(type);
+        alaio::input_stream bin{data, size};
+        alaio::json_dictionary_scope scope{context->json_dictionary.get()};
+        context->result_str = t->bin_to_json(bin);
+        if (bin.pos != bin.end)
+            throw std::runtime_error("Extra data");
+        return context->result_str.c_str();
+    });
+}
+
+extern "C" const char* abiala_hex_to_json_at(abiala_context* context, uint64_t contract, uint32_t block_num,
+                                             const char* type, const char* hex) {
+    fix_null_str(hex);
+    return handle_exceptions(context, nullptr, [&]() -> const char* {
+        std::vector<char> data;
+        std::string error;
+        if (!unhex(error, hex, hex + strlen(hex), std::back_inserter(data))) {
+            if (!error.empty())
+                set_error(context, std::move(error));
+            return nullptr;
+        }
+        return abiala_bin_to_json_at(context, contract, block_num, type, data.data(), data.size());
+    });
+}
+
 extern "C" abiala_bool abiala_abi_json_to_bin(abiala_context* context, const char* abi_json) {
     fix_null_str(abi_json);
     return handle_exceptions(context, false, [&] {
@@ -72,6 +72,50 @@ const char* abiala_bin_to_json(abiala_context* context, uint64_t contract, const
 // error.
 const char* abiala_hex_to_json(abiala_context* context, uint64_t contract, const char* type, const char* hex);
 
+// Set the abi (JSON format) which is active starting at block_num. It stays active until the next abi set at a later
+// block for the same contract. Returns false on error.
+abiala_bool abiala_set_abi_at(abiala_context* context, uint64_t contract, uint32_t block_num, const char* abi);
+
+// Set the abi (binary format) which is active starting at block_num. Returns false on error.
+abiala_bool abiala_set_abi_bin_at(abiala_context* context, uint64_t contract, uint32_t block_num, const char* data,
+                                  size_t size);
+
+// Set the abi (hex format) which is active starting at block_num. Returns false on error.
+abiala_bool abiala_set_abi_hex_at(abiala_context* context, uint64_t contract, uint32_t block_num, const char* hex);
+
+// Limit the approximate memory used by compiled abis set with abiala_set_abi*_at. Least recently used abis over the
+// limit are dropped and recompiled on demand.
+void abiala_set_abi_memory_limit(abiala_context* context, size_t limit);
+
+// Keep pre-rendered JSON for frequently seen names and symbols, up to capacity values, and use it in the
+// abiala_bin_to_json* and abiala_hex_to_json* functions. 0 removes the dictionary.
+void abiala_set_json_dictionary(abiala_context* context, size_t capacity);
+
+// Get the type name for an action at block_num. The context owns the returned memory. Returns null on error; use
+// abiala_get_error to retrieve error.
+const char* abiala_get_type_for_action_at(abiala_context* context, uint64_t contract, uint32_t block_num,
+                                          uint64_t action);
+
+// Get the type name for a table at block_num. The context owns the returned memory. Returns null on error; use
+// abiala_get_error to retrieve error.
+const char* abiala_get_type_for_table_at(abiala_context* context, uint64_t contract, uint32_t block_num,
+                                         uint64_t table);
+
+// Convert json to binary using the abi active at block_num. Use abiala_get_bin_* to retrieve result. Returns false on
+// error.
+abiala_bool abiala_json_to_bin_at(abiala_context* context, uint64_t contract, uint32_t block_num, const char* type,
+                                  const char* json);
+
+// Convert binary to json using the abi active at block_num. The context owns the returned string. Returns null on
+// error; use abiala_get_error to retrieve error.
+const char* abiala_bin_to_json_at(abiala_context* context, uint64_t contract, uint32_t block_num, const char* type,
+                                  const char* data, size_t size);
+
+// Convert hex to json using the abi active at block_num. The context owns the returned memory. Returns null on error;
+// use abiala_get_error to retrieve error.
+const char* abiala_hex_to_json_at(abiala_context* context, uint64_t contract, uint32_t block_num, const char* type,
+                                  const char* hex);
+
 // Convert abi json to bin, Use abiala_get_bin_* to retrieve result. Returns false on error.
 abiala_bool abiala_abi_json_to_bin(abiala_context* context, const char* json);
 
@@ -275,11 +275,11 @@ struct json_to_bin_state : alaio::json_token_stream {
 
 struct bin_to_json_state {
     alaio::input_stream& bin;
-    alaio::vector_stream& writer;
+    alaio::string_stream& writer;
     std::vector<bin_to_json_stack_entry> stack{};
     bool skipped_extension = false;
 
-    bin_to_json_state(alaio::input_stream& bin, alaio::vector_stream& writer)
+    bin_to_json_state(alaio::input_stream& bin, alaio::string_stream& writer)
         : bin{bin}, writer{writer} {}
 };
 
@@ -294,6 +294,7 @@ struct abi_serializer {
                                           bool start) const = 0;
   virtual void bin_to_json(::abiala::bin_to_json_state& state, bool allow_extensions, const abi_type* type,
                                           bool start) const = 0;
+  virtual void skip_bin(alaio::input_stream& bin, bool allow_extensions, const abi_type* type, int depth) const = 0;
 };
 
 }
@@ -430,21 +431,29 @@ void from_json(int128& obj, S& stream) {
 
 template <typename S>
 void to_json(const uint128& obj, S& stream) {
-    auto s = "\"" + binary_to_decimal(obj.data) + "\"";
-    stream.write(s.data(), s.size());
+    char buf[44];
+    char* end = buf;
+    *end++ = '"';
+    end = binary_to_decimal(obj.data, end);
+    *end++ = '"';
+    stream.write(buf, end - buf);
 }
 
 template <typename S>
 void to_json(const int128& obj, S& stream) {
+    char buf[44];
+    char* end = buf;
+    *end++ = '"';
     if (is_negative(obj.data)) {
         auto n = obj;
         negate(n.data);
-        auto s = "\"-" + binary_to_decimal(n.data) + "\"";
-        stream.write(s.data(), s.size());
+        *end++ = '-';
+        end = binary_to_decimal(n.data, end);
     } else {
-        auto s = "\"" + binary_to_decimal(obj.data) + "\"";
-        stream.write(s.data(), s.size());
+        end = binary_to_decimal(obj.data, end);
     }
+    *end++ = '"';
+    stream.write(buf, end - buf);
 }
 
 #endif
@@ -884,9 +893,8 @@ inline void json_to_bin(pseudo_variant*, json_to_bin_state& state, bool allow_ex
 
 template<typename F>
 inline void bin_to_json(alaio::input_stream& bin, const abi_type* type, std::string& dest, F&& f) {
-    // FIXME: Write directly to the string instead of creating an additional buffer
-    std::vector<char> buffer;
-    alaio::vector_stream writer{buffer};
+    std::string result;
+    alaio::string_stream writer{result};
     bin_to_json_state state{bin, writer};
     type->ser->bin_to_json(state, true, type, true);
     while (!state.stack.empty()) {
@@ -896,7 +904,7 @@ inline void bin_to_json(alaio::input_stream& bin, const abi_type* type, std::str
         alaio::check(state.stack.size() <= max_stack_size,
             alaio::convert_abi_error(alaio::abi_error::recursion_limit_reached));
     }
-    dest = std::string_view(writer.data.data(), writer.data.size());
+    dest.swap(result);
 }
 
 inline void bin_to_json(bin_to_json_state& state, bool allow_extensions, const abi_type* type, bool start) {
@@ -949,9 +957,31 @@ inline void bin_to_json(pseudo_object*, bin_to_json_state& state, bool allow_ext
     }
 }
 
+// Converts a whole array of signatures at once so that their checksums are hashed together
+inline void signatures_bin_to_json(bin_to_json_state& state, uint32_t size) {
+    std::vector<alaio::signature> signatures;
+    for (uint32_t i = 0; i < size; ++i) {
+        from_bin(signatures.emplace_back(), state.bin);
+    }
+    state.writer.write('[');
+    bool first = true;
+    for (auto& s : alaio::signatures_to_string(signatures)) {
+        if (!first) { state.writer.write(','); }
+        first = false;
+        to_json(s, state.writer);
+    }
+    state.writer.write(']');
+}
+
 inline void bin_to_json(pseudo_array*, bin_to_json_state& state, bool, const abi_type* type,
                                          bool start) {
     if (start) {
+        auto element = type->array_of();
+        if (std::holds_alternative<abi_type::builtin>(element->_data) && element->name == "signature") {
+            uint32_t size;
+            varuint32_from_bin(size, state.bin);
+            return signatures_bin_to_json(state, size);
+        }
         state.stack.push_back({type, false});
         varuint32_from_bin(state.stack.back().array_size, state.bin);
         if (trace_bin_to_json)
@@ -1008,4 +1038,59 @@ auto bin_to_json(T* t, bin_to_json_state& state, bool, const abi_type*, bool sta
     return to_json(v, state.writer);
 }
 
+// skip_bin
+///////////////////////////////////////////////////////////////////////////////
+
+// Follows the decoding rules of bin_to_json, but only moves bin
+inline void skip_bin(alaio::input_stream& bin, bool allow_extensions, const abi_type* type, int depth) {
+    alaio::check(depth < (int)max_stack_size,
+        alaio::convert_abi_error(alaio::abi_error::recursion_limit_reached));
+    type->ser->skip_bin(bin, allow_extensions, type, depth + 1);
+}
+
+inline void skip_bin(pseudo_optional*, alaio::input_stream& bin, bool allow_extensions, const abi_type* type,
+                     int depth) {
+    bool present;
+    from_bin(present, bin);
+    if (present)
+        skip_bin(bin, allow_extensions, type->optional_of(), depth);
+}
+
+inline void skip_bin(pseudo_extension*, alaio::input_stream& bin, bool allow_extensions, const abi_type* type,
+                     int depth) {
+    skip_bin(bin, allow_extensions, type->extension_of(), depth);
+}
+
+inline void skip_bin(pseudo_object*, alaio::input_stream& bin, bool allow_extensions, const abi_type* type,
+                     int depth) {
+    const std::vector<alaio::abi_field>& fields = type->as_struct()->fields;
+    for (auto& field : fields) {
+        if (bin.pos == bin.end && field.type->extension_of() && allow_extensions)
+            continue;
+        skip_bin(bin, allow_extensions && &field == &fields.back(), field.type, depth);
+    }
+}
+
+inline void skip_bin(pseudo_array*, alaio::input_stream& bin, bool, const abi_type* type, int depth) {
+    uint32_t size;
+    varuint32_from_bin(size, bin);
+    auto element = type->array_of();
+    for (uint32_t i = 0; i < size; ++i)
+        skip_bin(bin, false, element, depth);
+}
+
+inline void skip_bin(pseudo_variant*, alaio::input_stream& bin, bool allow_extensions, const abi_type* type,
+                     int depth) {
+    uint32_t index;
+    varuint32_from_bin(index, bin);
+    const std::vector<alaio::abi_field>& fields = *type->as_variant();
+    alaio::check(index < fields.size(), alaio::convert_stream_error(alaio::stream_error::bad_variant_index));
+    skip_bin(bin, allow_extensions, fields[index].type, depth);
+}
+
+template <typename T>
+void skip_bin(T*, alaio::input_stream& bin, bool, const abi_type*, int) {
+    alaio::skip_bin((T*)nullptr, bin);
+}
+
 } // namespace abiala
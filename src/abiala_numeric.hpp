@@ -8,6 +8,7 @@
 #include <string>
 #include <string_view>
 #include <alaio/from_json.hpp>
+#include <alaio/number_format.hpp>
 
 #include "abiala_ripemd160.hpp"
 
@@ -54,41 +55,72 @@ void negate(std::array<uint8_t, size>& a) {
     }
 }
 
+// decimal_to_binary and binary_to_decimal work on little-endian 32-bit limbs so that each step handles 9 decimal digits
+// with 64-bit arithmetic
+inline constexpr uint32_t decimal_chunk_scale[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+                                                   1000000000};
+
 template <auto size>
-inline void decimal_to_binary(std::array<uint8_t, size>& result,
-                                                              std::string_view s) {
-    memset(result.begin(), 0, result.size());
-    for (auto& src_digit : s) {
-       alaio::check(!(src_digit < '0' || src_digit > '9'),
-            alaio::convert_json_error(alaio::from_json_error::expected_int));
-        uint8_t carry = src_digit - '0';
-        for (auto& result_byte : result) {
-            int x = result_byte * 10 + carry;
-            result_byte = x;
-            carry = x >> 8;
+inline void decimal_to_binary(std::array<uint8_t, size>& result, std::string_view s) {
+    static_assert(size % 4 == 0);
+    std::array<uint32_t, size / 4> limbs{};
+    const char* pos = s.data();
+    const char* end = s.data() + s.size();
+    while (pos != end) {
+        const char* chunk_begin = pos;
+        const char* chunk_end = pos + std::min<std::ptrdiff_t>(end - pos, 9);
+        uint32_t chunk = 0;
+        while (pos != chunk_end && *pos >= '0' && *pos <= '9')
+            chunk = chunk * 10 + (*pos++ - '0');
+        uint64_t carry = chunk;
+        for (auto& limb : limbs) {
+            carry += uint64_t(limb) * decimal_chunk_scale[pos - chunk_begin];
+            limb = uint32_t(carry);
+            carry >>= 32;
         }
+        // digits before a bad character still count towards overflow, which is reported first
         alaio::check(!carry,
               alaio::convert_json_error(alaio::from_json_error::number_out_of_range));
+        alaio::check(pos == chunk_end,
+            alaio::convert_json_error(alaio::from_json_error::expected_int));
     }
+    memcpy(result.data(), limbs.data(), size);
 }
 
+// Writes bin as an unsigned decimal to dest and returns the end. dest needs room for size * 5 / 2 + 1 characters.
 template <auto size>
-std::string binary_to_decimal(const std::array<uint8_t, size>& bin) {
-    std::string result("0");
-    for (auto byte_it = bin.rbegin(); byte_it != bin.rend(); ++byte_it) {
-        int carry = *byte_it;
-        for (auto& result_digit : result) {
-            int x = ((result_digit - '0') << 8) + carry;
-            result_digit = '0' + x % 10;
-            carry = x / 10;
-        }
-        while (carry) {
-            result.push_back('0' + carry % 10);
-            carry = carry / 10;
+char* binary_to_decimal(const std::array<uint8_t, size>& bin, char* dest) {
+    static_assert(size % 4 == 0);
+    std::array<uint32_t, size / 4> limbs;
+    memcpy(limbs.data(), bin.data(), size);
+    uint32_t chunks[size / 3 + 1]; // base 10^9, lowest first
+    int num_chunks = 0;
+    int top = limbs.size();
+    while (top && !limbs[top - 1])
+        --top;
+    do {
+        uint64_t rem = 0;
+        for (int i = top; i-- > 0;) {
+            uint64_t x = (rem << 32) | limbs[i];
+            limbs[i] = uint32_t(x / 1000000000);
+            rem = x % 1000000000;
         }
+        chunks[num_chunks++] = rem;
+        while (top && !limbs[top - 1])
+            --top;
+    } while (top);
+    dest = alaio::uint64_to_decimal(chunks[--num_chunks], dest);
+    while (num_chunks) {
+        alaio::write_decimal_digits(chunks[--num_chunks], dest + 9, 9);
+        dest += 9;
     }
-    std::reverse(result.begin(), result.end());
-    return result;
+    return dest;
+}
+
+template <auto size>
+std::string binary_to_decimal(const std::array<uint8_t, size>& bin) {
+    char buf[size * 5 / 2 + 1];
+    return std::string(buf, binary_to_decimal(bin, buf));
 }
 
 } // namespace abiala
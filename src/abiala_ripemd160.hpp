@@ -45,8 +45,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include <assert.h>
+#include <stdint.h>
 #include <string.h>
+#include <string_view>
+#include <utility>
 
 namespace abiala_ripemd160 {
 
@@ -66,12 +70,9 @@ typedef struct {
     uint8_t bufpos; /* number of bytes currently in the buffer */
 } ripemd160_state;
 
-/* cyclic left-shift the 32-bit word n left by s bits */
-#define ROL(s, n) (((n) << (s)) | ((n) >> (32 - (s))))
-
 /* Initial values for the chaining variables.
  * This is just 0123456789ABCDEFFEDCBA9876543210F0E1D2C3 in little-endian. */
-inline const uint32_t initial_h[5] = {0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u, 0xC3D2E1F0u};
+inline constexpr uint32_t initial_h[5] = {0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u, 0xC3D2E1F0u};
 
 /* Ordering of message words.  Based on the permutations rho(i) and pi(i), defined as follows:
  *
@@ -86,7 +87,7 @@ inline const uint32_t initial_h[5] = {0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x1
  */
 
 /* Left line */
-inline const uint8_t RL[5][16] = {
+inline constexpr uint8_t RL[5][16] = {
     {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}, /* Round 1: id */
     {7, 4, 13, 1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8}, /* Round 2: rho */
     {3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5, 12}, /* Round 3: rho^2 */
@@ -95,7 +96,7 @@ inline const uint8_t RL[5][16] = {
 };
 
 /* Right line */
-inline const uint8_t RR[5][16] = {
+inline constexpr uint8_t RR[5][16] = {
     {5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12}, /* Round 1: pi */
     {6, 11, 3, 7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2}, /* Round 2: rho pi */
     {15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4, 13}, /* Round 3: rho^2 pi */
@@ -110,7 +111,7 @@ inline const uint8_t RR[5][16] = {
  */
 
 /* Shifts, left line */
-inline const uint8_t SL[5][16] = {
+inline constexpr uint8_t SL[5][16] = {
     {11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8}, /* Round 1 */
     {7, 6, 8, 13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12}, /* Round 2 */
     {11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5, 12, 7, 5}, /* Round 3 */
@@ -119,7 +120,7 @@ inline const uint8_t SL[5][16] = {
 };
 
 /* Shifts, right line */
-inline const uint8_t SR[5][16] = {
+inline constexpr uint8_t SR[5][16] = {
     {8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6}, /* Round 1 */
     {9, 13, 15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11}, /* Round 2 */
     {9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13, 13, 7, 5}, /* Round 3 */
@@ -136,7 +137,7 @@ inline const uint8_t SR[5][16] = {
 #define F5(x, y, z) ((x) ^ ((y) | ~(z)))
 
 /* Round constants, left line */
-inline const uint32_t KL[5] = {
+inline constexpr uint32_t KL[5] = {
     0x00000000u, /* Round 1: 0 */
     0x5A827999u, /* Round 2: floor(2**30 * sqrt(2)) */
     0x6ED9EBA1u, /* Round 3: floor(2**30 * sqrt(3)) */
@@ -145,7 +146,7 @@ inline const uint32_t KL[5] = {
 };
 
 /* Round constants, right line */
-inline const uint32_t KR[5] = {
+inline constexpr uint32_t KR[5] = {
     0x50A28BE6u, /* Round 1: floor(2**30 * cubert(2)) */
     0x5C4DD124u, /* Round 2: floor(2**30 * cubert(3)) */
     0x6D703EF3u, /* Round 3: floor(2**30 * cubert(5)) */
@@ -156,7 +157,6 @@ inline const uint32_t KR[5] = {
 inline void ripemd160_init(ripemd160_state* self) {
 
     memcpy(self->h, initial_h, ripemd160_digest_size);
-    memset(&self->buf, 0, sizeof(self->buf));
     self->length = 0;
     self->bufpos = 0;
     self->magic = ripemd160_magic;
@@ -196,13 +196,65 @@ inline void byteswap_digest(uint32_t* p) {
     }
 }
 
+/* The compression function, unrolled at compile time. W is uint32_t, or a vector of them to hash several
+ * independent messages at once (one per lane). x holds the 16 words of the block. */
+template <int S, typename W>
+__attribute__((always_inline)) inline W rol(W x) {
+    return (x << S) | (x >> (32 - S));
+}
+
+template <int Fn, typename W>
+__attribute__((always_inline)) inline W boolean_fn(W x, W y, W z) {
+    if constexpr (Fn == 0)
+        return F1(x, y, z);
+    else if constexpr (Fn == 1)
+        return F2(x, y, z);
+    else if constexpr (Fn == 2)
+        return F3(x, y, z);
+    else if constexpr (Fn == 3)
+        return F4(x, y, z);
+    else
+        return F5(x, y, z);
+}
+
+template <int J, typename W>
+__attribute__((always_inline)) inline void compress_step(W (&l)[5], W (&r)[5], const W* x) {
+    constexpr int round = J / 16, w = J % 16;
+    W t = rol<SL[round][w]>(l[0] + boolean_fn<round>(l[1], l[2], l[3]) + x[RL[round][w]] + KL[round]) + l[4];
+    l[0] = l[4];
+    l[4] = l[3];
+    l[3] = rol<10>(l[2]);
+    l[2] = l[1];
+    l[1] = t;
+    t = rol<SR[round][w]>(r[0] + boolean_fn<4 - round>(r[1], r[2], r[3]) + x[RR[round][w]] + KR[round]) + r[4];
+    r[0] = r[4];
+    r[4] = r[3];
+    r[3] = rol<10>(r[2]);
+    r[2] = r[1];
+    r[1] = t;
+}
+
+template <typename W, int... J>
+__attribute__((always_inline)) inline void compress_steps(W (&l)[5], W (&r)[5], const W* x,
+                                                          std::integer_sequence<int, J...>) {
+    (compress_step<J>(l, r, x), ...);
+}
+
+template <typename W>
+inline void compress(W* h, const W* x) {
+    W l[5] = {h[0], h[1], h[2], h[3], h[4]};
+    W r[5] = {h[0], h[1], h[2], h[3], h[4]};
+    compress_steps(l, r, x, std::make_integer_sequence<int, 80>{});
+    W t = h[1] + l[2] + r[3];
+    h[1] = h[2] + l[3] + r[4];
+    h[2] = h[3] + l[4] + r[0];
+    h[3] = h[4] + l[0] + r[1];
+    h[4] = h[0] + l[1] + r[2];
+    h[0] = t;
+}
+
 /* The RIPEMD160 compression function.  Operates on self->buf */
 inline void ripemd160_compress(ripemd160_state* self) {
-    uint8_t w, round;
-    uint32_t T;
-    uint32_t AL, BL, CL, DL, EL; /* left line */
-    uint32_t AR, BR, CR, DR, ER; /* right line */
-
     /* Sanity check */
     assert(self->magic == ripemd160_magic);
     assert(self->bufpos == 64);
@@ -210,120 +262,7 @@ inline void ripemd160_compress(ripemd160_state* self) {
         ripemd160_wipe(self);
         return; /* error */
     }
-
-    /* Load the left and right lines with the initial state */
-    AL = AR = self->h[0];
-    BL = BR = self->h[1];
-    CL = CR = self->h[2];
-    DL = DR = self->h[3];
-    EL = ER = self->h[4];
-
-    /* Round 1 */
-    round = 0;
-    for (w = 0; w < 16; w++) { /* left line */
-        T = ROL(SL[round][w], AL + F1(BL, CL, DL) + self->buf.w[RL[round][w]] + KL[round]) + EL;
-        AL = EL;
-        EL = DL;
-        DL = ROL(10, CL);
-        CL = BL;
-        BL = T;
-    }
-    for (w = 0; w < 16; w++) { /* right line */
-        T = ROL(SR[round][w], AR + F5(BR, CR, DR) + self->buf.w[RR[round][w]] + KR[round]) + ER;
-        AR = ER;
-        ER = DR;
-        DR = ROL(10, CR);
-        CR = BR;
-        BR = T;
-    }
-
-    /* Round 2 */
-    round++;
-    for (w = 0; w < 16; w++) { /* left line */
-        T = ROL(SL[round][w], AL + F2(BL, CL, DL) + self->buf.w[RL[round][w]] + KL[round]) + EL;
-        AL = EL;
-        EL = DL;
-        DL = ROL(10, CL);
-        CL = BL;
-        BL = T;
-    }
-    for (w = 0; w < 16; w++) { /* right line */
-        T = ROL(SR[round][w], AR + F4(BR, CR, DR) + self->buf.w[RR[round][w]] + KR[round]) + ER;
-        AR = ER;
-        ER = DR;
-        DR = ROL(10, CR);
-        CR = BR;
-        BR = T;
-    }
-
-    /* Round 3 */
-    round++;
-    for (w = 0; w < 16; w++) { /* left line */
-        T = ROL(SL[round][w], AL + F3(BL, CL, DL) + self->buf.w[RL[round][w]] + KL[round]) + EL;
-        AL = EL;
-        EL = DL;
-        DL = ROL(10, CL);
-        CL = BL;
-        BL = T;
-    }
-    for (w = 0; w < 16; w++) { /* right line */
-        T = ROL(SR[round][w], AR + F3(BR, CR, DR) + self->buf.w[RR[round][w]] + KR[round]) + ER;
-        AR = ER;
-        ER = DR;
-        DR = ROL(10, CR);
-        CR = BR;
-        BR = T;
-    }
-
-    /* Round 4 */
-    round++;
-    for (w = 0; w < 16; w++) { /* left line */
-        T = ROL(SL[round][w], AL + F4(BL, CL, DL) + self->buf.w[RL[round][w]] + KL[round]) + EL;
-        AL = EL;
-        EL = DL;
-        DL = ROL(10, CL);
-        CL = BL;
-        BL = T;
-    }
-    for (w = 0; w < 16; w++) { /* right line */
-        T = ROL(SR[round][w], AR + F2(BR, CR, DR) + self->buf.w[RR[round][w]] + KR[round]) + ER;
-        AR = ER;
-        ER = DR;
-        DR = ROL(10, CR);
-        CR = BR;
-        BR = T;
-    }
-
-    /* Round 5 */
-    round++;
-    for (w = 0; w < 16; w++) { /* left line */
-        T = ROL(SL[round][w], AL + F5(BL, CL, DL) + self->buf.w[RL[round][w]] + KL[round]) + EL;
-        AL = EL;
-        EL = DL;
-        DL = ROL(10, CL);
-        CL = BL;
-        BL = T;
-    }
-    for (w = 0; w < 16; w++) { /* right line */
-        T = ROL(SR[round][w], AR + F1(BR, CR, DR) + self->buf.w[RR[round][w]] + KR[round]) + ER;
-        AR = ER;
-        ER = DR;
-        DR = ROL(10, CR);
-        CR = BR;
-        BR = T;
-    }
-
-    /* Final mixing stage */
-    T = self->h[1] + CL + DR;
-    self->h[1] = self->h[2] + DL + ER;
-    self->h[2] = self->h[3] + EL + AR;
-    self->h[3] = self->h[4] + AL + BR;
-    self->h[4] = self->h[0] + BL + CR;
-    self->h[0] = T;
-
-    /* Clear the buffer and wipe the temporary variables */
-    T = AL = BL = CL = DL = EL = AR = BR = CR = DR = ER = 0;
-    memset(&self->buf, 0, sizeof(self->buf));
+    compress(self->h, self->buf.w);
     self->bufpos = 0;
 }
 
@@ -389,9 +328,11 @@ inline int ripemd160_digest(const ripemd160_state* self, unsigned char* out) {
     tmp.buf.b[tmp.bufpos++] = 0x80;
 
     if (tmp.bufpos > 56) {
+        memset(tmp.buf.b + tmp.bufpos, 0, 64 - tmp.bufpos);
         tmp.bufpos = 64;
         ripemd160_compress(&tmp);
     }
+    memset(tmp.buf.b + tmp.bufpos, 0, 56 - tmp.bufpos);
 
     /* Append the length */
     tmp.buf.w[14] = (uint32_t)(tmp.length & 0xFFFFffffu);
@@ -404,14 +345,82 @@ inline int ripemd160_digest(const ripemd160_state* self, unsigned char* out) {
 
     if (tmp.magic == ripemd160_magic) {
         /* success */
-        ripemd160_wipe(&tmp);
         return 1;
     } else {
         /* error */
-        ripemd160_wipe(&tmp);
         memset(out, 0, ripemd160_digest_size);
         return 0;
     }
 }
 
+/* Multi-buffer hashing: ripemd160_lanes independent messages go through one vectorized compression per block. GCC and
+ * clang lower the vector type to SSE/AVX/NEON as available, or to scalar code. */
+#ifdef __AVX2__
+inline constexpr int ripemd160_lanes = 8;
+#else
+inline constexpr int ripemd160_lanes = 4;
+#endif
+typedef uint32_t ripemd160_lane_words __attribute__((vector_size(4 * ripemd160_lanes)));
+
+/* Messages longer than this are hashed one at a time */
+inline constexpr std::size_t ripemd160_max_lane_blocks = 4;
+
+inline void ripemd160(const void* data, std::size_t size, unsigned char* out) {
+    ripemd160_state state;
+    ripemd160_init(&state);
+    ripemd160_update(&state, static_cast<const uint8_t*>(data), int(size));
+    ripemd160_digest(&state, out);
+}
+
+/* Writes the digest of messages[i] to out + 20 * i */
+inline void ripemd160_many(const std::string_view* messages, std::size_t count, unsigned char* out) {
+    constexpr std::size_t max_size = ripemd160_max_lane_blocks * 64 - 9;
+    for (std::size_t base = 0; base < count; base += ripemd160_lanes) {
+        std::size_t n = std::min<std::size_t>(ripemd160_lanes, count - base);
+        uint32_t words[ripemd160_max_lane_blocks][16][ripemd160_lanes] = {};
+        std::size_t num_blocks[ripemd160_lanes] = {};
+        std::size_t max_blocks = 0;
+        for (std::size_t lane = 0; lane < n; ++lane) {
+            auto msg = messages[base + lane];
+            if (msg.size() > max_size) {
+                ripemd160(msg.data(), msg.size(), out + 20 * (base + lane));
+                continue;
+            }
+            union {
+                uint32_t w[ripemd160_max_lane_blocks * 16];
+                uint8_t b[ripemd160_max_lane_blocks * 64];
+            } padded = {};
+            memcpy(padded.b, msg.data(), msg.size());
+            padded.b[msg.size()] = 0x80;
+            std::size_t blocks = (msg.size() + 8) / 64 + 1;
+            uint64_t bits = uint64_t(msg.size()) << 3;
+            padded.w[blocks * 16 - 2] = uint32_t(bits);
+            padded.w[blocks * 16 - 1] = uint32_t(bits >> 32);
+            for (std::size_t i = 0; i < blocks * 16; ++i)
+                words[i / 16][i % 16][lane] = padded.w[i];
+            num_blocks[lane] = blocks;
+            max_blocks = std::max(max_blocks, blocks);
+        }
+        ripemd160_lane_words h[5];
+        for (int i = 0; i < 5; ++i)
+            h[i] = ripemd160_lane_words{} + initial_h[i];
+        for (std::size_t block = 0; block < max_blocks; ++block) {
+            ripemd160_lane_words x[16], next[5], active;
+            memcpy(x, words[block], sizeof(x));
+            memcpy(next, h, sizeof(h));
+            compress(next, x);
+            for (int lane = 0; lane < ripemd160_lanes; ++lane)
+                active[lane] = block < num_blocks[lane] ? ~0u : 0;
+            for (int i = 0; i < 5; ++i)
+                h[i] = (next[i] & active) | (h[i] & ~active);
+        }
+        for (std::size_t lane = 0; lane < n; ++lane) {
+            if (!num_blocks[lane])
+                continue;
+            uint32_t digest[5] = {h[0][lane], h[1][lane], h[2][lane], h[3][lane], h[4][lane]};
+            memcpy(out + 20 * (base + lane), digest, 20);
+        }
+    }
+}
+
 } // namespace ripemd160
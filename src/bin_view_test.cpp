@@ -0,0 +1,330 @@
+#include <alaio/abi.hpp>
+#include <alaio/ship_protocol.hpp>
+#include <alaio/ship_protocol_pmr.hpp>
+
+#include <cstdio>
+#include <string>
+
+int error_count;
+
+void report_error(const char* assertion, const char* file, int line) {
+    if(error_count <= 20) {
+       printf("%s:%d: failed %s\n", file, line, assertion);
+    }
+    ++error_count;
+}
+
+#define CHECK(...) do { if(__VA_ARGS__) {} else { report_error(#__VA_ARGS__, __FILE__, __LINE__); } } while(0)
+
+using namespace alaio::ship_protocol;
+using alaio::name;
+
+transaction_trace_v0 make_trace(std::string_view console, const std::vector<char>& return_value) {
+   transaction_trace_v0 trace;
+   trace.id = alaio::checksum256(std::array<uint8_t, 32>{ 1, 2, 3 });
+   trace.status = transaction_status::soft_fail;
+   trace.cpu_usage_us = 123;
+   trace.net_usage_words = 300;
+   trace.scheduled = true;
+
+   action_trace_v0 a0;
+   a0.receiver = name("alice");
+   a0.act.account = name("alaio.token");
+   a0.act.name = name("transfer");
+   a0.act.authorization.push_back({ name("alice"), name("active") });
+   a0.console = console;
+   a0.account_ram_deltas.push_back({ name("alice"), -5 });
+   a0.receipt = action_receipt{ action_receipt_v0{ name("alice"), {}, 7, 8, { { name("alice"), 9 } }, 1, 2 } };
+   trace.action_traces.push_back(a0);
+
+   action_trace_v1 a1;
+   a1.receiver = name("bob");
+   a1.act.name = name("notify");
+   a1.except = "failed";
+   a1.error_code = 17;
+   a1.return_value = alaio::input_stream{ return_value };
+   trace.action_traces.push_back(a1);
+
+   trace.account_ram_delta = account_delta{ name("carol"), 12 };
+   trace.except = "trace failed";
+   return trace;
+}
+
+void test_skip_bin() {
+   std::vector<char> rv{ 'r', 'v' };
+   auto outer = make_trace("hello", rv);
+   outer.failed_dtrx_trace.push_back({ transaction_trace{ make_trace("nested", rv) } });
+   outer.partial = partial_transaction{ partial_transaction_v0{ {}, 1, 2, 3, 4, 5, { { 1, {} } }, { alaio::signature{} }, {} } };
+   auto bin = alaio::convert_to_bin(std::vector<transaction_trace>{ outer, outer });
+   bin.push_back('x');
+
+   alaio::input_stream stream{ bin };
+   alaio::skip_bin((std::vector<transaction_trace>*)nullptr, stream);
+   CHECK(stream.remaining() == 1);
+
+   std::vector<char> vu = alaio::convert_to_bin(std::vector<alaio::varuint32>{ 1, 300, 70000 });
+   alaio::input_stream vstream{ vu };
+   alaio::skip_bin((std::vector<alaio::varuint32>*)nullptr, vstream);
+   CHECK(vstream.remaining() == 0);
+}
+
+void test_views() {
+   std::vector<char> rv{ 'r', 'v' };
+   auto outer = make_trace("hello", rv);
+   outer.failed_dtrx_trace.push_back({ transaction_trace{ make_trace("nested", rv) } });
+   auto bin = alaio::convert_to_bin(std::vector<transaction_trace>{ outer });
+
+   alaio::bin_vector_view<transaction_trace> traces{ alaio::input_stream{ bin } };
+   CHECK(traces.size() == 1);
+   int num_traces = 0;
+   for (auto t : traces) {
+      ++num_traces;
+      auto& trace = std::get<transaction_trace_v0_view>(t);
+      // out of declaration order
+      CHECK(trace.except() == std::optional<std::string_view>{ "trace failed" });
+      CHECK(trace.id() == outer.id);
+      CHECK(trace.status() == transaction_status::soft_fail);
+      CHECK(trace.net_usage_words().value == 300);
+      CHECK(trace.scheduled());
+      CHECK(trace.account_ram_delta()->delta == 12);
+      CHECK(!trace.partial());
+      CHECK(trace.size() == bin.size() - 2); // vector size and variant index
+
+      auto actions = trace.action_traces();
+      CHECK(actions.size() == 2);
+      auto it = actions.begin();
+      auto a0 = std::get<action_trace_v0_view>(*it);
+      CHECK(a0.receiver() == name("alice"));
+      CHECK(a0.act().account() == name("alaio.token"));
+      CHECK(a0.act().name() == name("transfer"));
+      CHECK(a0.console() == "hello");
+      CHECK(std::get<action_receipt_v0_view>(*a0.receipt()).global_sequence() == 7);
+      auto auth = a0.act().authorization();
+      CHECK(auth.size() == 1 && (*auth.begin()).permission == name("active"));
+      auto ram = a0.account_ram_deltas();
+      CHECK(ram.size() == 1 && (*ram.begin()).delta == -5);
+      CHECK(ram.decode() == std::vector<account_delta>{ { name("alice"), -5 } });
+      ++it;
+      auto a1 = std::get<action_trace_v1_view>(*it);
+      CHECK(a1.except() == std::optional<std::string_view>{ "failed" });
+      CHECK(a1.error_code() == 17u);
+      CHECK(!a1.receipt());
+      auto ret = a1.return_value();
+      CHECK(std::string(ret.pos, ret.end) == "rv");
+      CHECK(++it == actions.end());
+
+      auto failed = trace.failed_dtrx_trace();
+      CHECK(failed.size() == 1);
+      auto nested = std::get<transaction_trace_v0_view>(*failed.begin());
+      CHECK(std::get<action_trace_v0_view>(*nested.action_traces().begin()).console() == "nested");
+      CHECK(alaio::convert_to_bin(nested.decode()) == alaio::convert_to_bin(std::get<0>(outer.failed_dtrx_trace[0].recurse)));
+   }
+   CHECK(num_traces == 1);
+
+   table_delta_v0 delta{ "contract_row", { { true, alaio::input_stream{ rv } }, { false, {} } } };
+   auto delta_bin = alaio::convert_to_bin(table_delta{ delta });
+   auto view = alaio::bin_view_traits<table_delta>::read(alaio::input_stream{ delta_bin });
+   auto& d = std::get<table_delta_v0_view>(view);
+   CHECK(d.name() == "contract_row");
+   std::vector<bool> present;
+   for (auto row : d.rows()) present.push_back(row.present);
+   CHECK((present == std::vector<bool>{ true, false }));
+}
+
+void test_arena() {
+   std::vector<char> rv{ 'r', 'v' };
+   std::string console(100, 'c');
+   auto outer = make_trace(console, rv);
+   outer.failed_dtrx_trace.push_back({ transaction_trace{ make_trace("nested", rv) } });
+   outer.partial = partial_transaction{ partial_transaction_v0{ {}, 1, 2, 3, 4, 5, { { 1, {} } }, { alaio::signature{} }, {} } };
+   auto bin = alaio::convert_to_bin(std::vector<transaction_trace>{ outer, outer });
+
+   std::pmr::monotonic_buffer_resource arena;
+   for (int i = 0; i < 2; ++i) {
+      {
+         // anything not allocated from the arena throws
+         auto* prev = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+         alaio::arena_input_stream stream{ alaio::input_stream{ bin }, &arena };
+         std::pmr::vector<pmr::transaction_trace> traces;
+         bool ok = true;
+         try {
+            from_bin(traces, stream);
+         } catch (std::bad_alloc&) {
+            ok = false;
+         }
+         std::pmr::set_default_resource(prev);
+         CHECK(ok);
+         CHECK(stream.remaining() == 0);
+         CHECK(traces.size() == 2);
+         CHECK(traces.get_allocator().resource() == &arena);
+         if (ok) {
+            auto& t = std::get<pmr::transaction_trace_v0>(traces[1]);
+            auto& a0 = std::get<pmr::action_trace_v0>(t.action_traces[0]);
+            CHECK(std::string_view{ a0.console } == console);
+            CHECK(a0.console.get_allocator().resource() == &arena);
+            CHECK(std::get<pmr::action_trace_v1>(t.action_traces[1]).except->get_allocator().resource() == &arena);
+            CHECK(alaio::convert_to_bin(traces) == bin);
+            CHECK(alaio::convert_to_json(traces) == alaio::convert_to_json(std::vector<transaction_trace>{ outer, outer }));
+         }
+      }
+      arena.release();
+   }
+
+   // a plain input_stream uses the containers' own resource
+   alaio::input_stream stream{ bin };
+   std::pmr::vector<pmr::transaction_trace> traces;
+   from_bin(traces, stream);
+   CHECK(alaio::convert_to_bin(traces) == bin);
+}
+
+struct indexed_item {
+   alaio::varuint32                    id     = {};
+   std::string                         note   = {};
+   std::vector<std::string>            tags   = {};
+   std::optional<uint64_t>             amount = {};
+   std::variant<uint32_t, std::string> value  = {};
+};
+
+ALAIO_REFLECT(indexed_item, id, note, tags, amount, value)
+
+char indexed_item_abi[] = R"({
+    "version": "alaio::abi/1.1",
+    "structs": [
+        { "name": "item", "base": "", "fields": [
+            { "name": "id", "type": "varuint32" },
+            { "name": "note", "type": "string" },
+            { "name": "tags", "type": "string[]" },
+            { "name": "amount", "type": "uint64?" },
+            { "name": "value", "type": "value_t" }
+        ] },
+        { "name": "holder", "base": "", "fields": [
+            { "name": "items", "type": "item[]" },
+            { "name": "extra", "type": "uint32$" }
+        ] }
+    ],
+    "variants": [
+        { "name": "value_t", "types": ["uint32", "string"] }
+    ]
+})";
+
+void test_index() {
+   std::vector<char> rv{ 'r', 'v' }, no_rv;
+   std::string console(300, 'b');
+   std::vector<transaction_trace> traces{ make_trace("a", rv), make_trace(console, rv), make_trace("", no_rv) };
+   auto bin = alaio::convert_to_bin(traces);
+   bin.push_back('x');
+
+   alaio::bin_vector_view<transaction_trace> view{ alaio::input_stream{ bin } };
+   auto index = view.index();
+   CHECK(index.size() == 3);
+   for (uint32_t i = 0; i < 3; ++i) {
+      auto element = index.element(i);
+      CHECK(std::vector<char>(element.pos, element.end) == alaio::convert_to_bin(traces[i]));
+   }
+   auto a0 = std::get<action_trace_v0_view>(*std::get<transaction_trace_v0_view>(index[1]).action_traces().begin());
+   CHECK(a0.console() == console);
+   auto all = index.elements(0, 3);
+   CHECK(all.pos == bin.data() + 1 && all.end == bin.data() + bin.size() - 1);
+   CHECK((index.partition(1) == std::vector<uint32_t>{ 0, 3 }));
+   CHECK((index.partition(2) == std::vector<uint32_t>{ 0, 2, 3 }));
+   CHECK(index.partition(8).back() == 3);
+   CHECK(alaio::bin_vector_view<transaction_trace>{}.index().empty());
+   CHECK((alaio::bin_array_index{}.partition(4) == std::vector<uint32_t>{ 0, 0 }));
+
+   std::vector<char> truncated(bin.begin(), bin.end() - 2);
+   bool threw = false;
+   try {
+      alaio::bin_vector_view<transaction_trace>{ alaio::input_stream{ truncated } }.index();
+   } catch (std::exception&) {
+      threw = true;
+   }
+   CHECK(threw);
+
+   alaio::json_token_stream abi_stream(indexed_item_abi);
+   alaio::abi abi;
+   convert(alaio::from_json<alaio::abi_def>(abi_stream), abi);
+   auto item_type = abi.get_type("item");
+   std::vector<indexed_item> items{ { 1, "first", { "x", "y" }, 5, uint32_t(7) },
+                                    { 300, std::string(200, 'n'), {}, {}, std::string("seven") },
+                                    { 2, "", { "z" }, 0, uint32_t(0) } };
+   auto items_bin = alaio::convert_to_bin(items);
+   alaio::input_stream items_stream{ items_bin };
+   auto items_index = abi.get_type("item[]")->index_array(items_stream);
+   CHECK(items_stream.remaining() == 0);
+   CHECK(items_index.size() == 3);
+   for (uint32_t i = 0; i < 3; ++i) {
+      auto element = items_index.element(i);
+      auto expected = alaio::convert_to_bin(items[i]);
+      CHECK(std::vector<char>(element.pos, element.end) == expected);
+      alaio::input_stream expected_stream{ expected };
+      CHECK(item_type->bin_to_json(element) == item_type->bin_to_json(expected_stream));
+   }
+
+   // a trailing extension may be missing
+   auto holder_bin = items_bin;
+   alaio::input_stream holder_stream{ holder_bin };
+   abi.get_type("holder")->skip_bin(holder_stream);
+   CHECK(holder_stream.remaining() == 0);
+   holder_bin.insert(holder_bin.end(), { 1, 0, 0, 0 });
+   holder_stream = alaio::input_stream{ holder_bin };
+   abi.get_type("holder")->skip_bin(holder_stream);
+   CHECK(holder_stream.remaining() == 0);
+
+   alaio::input_stream short_stream{ items_bin.data() + 1, items_bin.data() + 4 };
+   threw = false;
+   try {
+      item_type->skip_bin(short_stream);
+   } catch (std::exception&) {
+      threw = true;
+   }
+   CHECK(threw);
+}
+
+// serializes as a uint64_t, so its memory image is not its serialized form
+struct widened_pod {
+   uint32_t v;
+};
+ALAIO_REFLECT(widened_pod, v);
+uint64_t serialize_as(const widened_pod& obj) { return obj.v; }
+
+static_assert(!alaio::has_bitwise_serialization<widened_pod>());
+static_assert(alaio::has_bitwise_serialization<name>());
+static_assert(alaio::has_bitwise_serialization<account_delta>());
+static_assert(alaio::has_bitwise_serialization<account_auth_sequence>());
+static_assert(alaio::has_bitwise_serialization<permission_level>());
+static_assert(!alaio::has_bitwise_serialization<alaio::varuint32>());
+static_assert(!alaio::has_bitwise_serialization<alaio::checksum256>());
+static_assert(!alaio::has_bitwise_serialization<block_position>());
+
+void test_bitwise_vectors() {
+   std::vector<account_auth_sequence> seqs{ { name("alice"), 1 }, { name("bob"), 0xffff'ffff'ffff } };
+   auto bin = alaio::convert_to_bin(seqs);
+   std::vector<char> expected{ 2 };
+   for (auto& s : seqs) {
+      auto field = alaio::convert_to_bin(s.account);
+      expected.insert(expected.end(), field.begin(), field.end());
+      field = alaio::convert_to_bin(s.sequence);
+      expected.insert(expected.end(), field.begin(), field.end());
+   }
+   CHECK(bin == expected);
+   CHECK(alaio::convert_from_bin<std::vector<account_auth_sequence>>(bin) == seqs);
+
+   // element count is checked against the input size before anything is allocated
+   std::vector<char> truncated(bin.begin(), bin.end() - 1);
+   bool threw = false;
+   try {
+      alaio::convert_from_bin<std::vector<account_auth_sequence>>(truncated);
+   } catch (std::exception&) {
+      threw = true;
+   }
+   CHECK(threw);
+}
+
+int main() {
+   test_bitwise_vectors();
+   test_skip_bin();
+   test_views();
+   test_arena();
+   test_index();
+   if(error_count) return 1;
+}
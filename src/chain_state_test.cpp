@@ -0,0 +1,208 @@
+#include <alaio/chain_state.hpp>
+
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+
+int error_count;
+
+void report_error(const char* assertion, const char* file, int line) {
+    if(error_count <= 20) {
+       printf("%s:%d: failed %s\n", file, line, assertion);
+    }
+    ++error_count;
+}
+
+#define CHECK(...) do { if(__VA_ARGS__) {} else { report_error(#__VA_ARGS__, __FILE__, __LINE__); } } while(0)
+
+using namespace alaio::ship_protocol;
+using alaio::name;
+
+void test_btree() {
+   alaio::bytes_btree tree;
+   std::map<std::string, std::string> expected;
+   std::mt19937 rng(1);
+   auto random_key = [&] { return std::to_string(rng() % 5000); };
+   auto check_same = [&] {
+      CHECK(tree.size() == expected.size());
+      auto it = tree.begin();
+      for (auto& [k, v] : expected) {
+         if (it == tree.end() || it->key() != k || it->value() != v) {
+            CHECK(!"btree content mismatch");
+            return;
+         }
+         ++it;
+      }
+      CHECK(it == tree.end());
+   };
+
+   for (int round = 0; round < 3; ++round) {
+      for (int i = 0; i < 20000; ++i) {
+         auto k = random_key();
+         if (rng() % 3) {
+            auto v = std::string(rng() % 40, 'a' + rng() % 26);
+            tree.put(k, v);
+            expected[k] = v;
+         } else {
+            CHECK(tree.erase(k) == (expected.erase(k) == 1));
+         }
+      }
+      check_same();
+      for (int i = 0; i < 1000; ++i) {
+         auto k  = random_key();
+         auto it = tree.lower_bound(k);
+         auto e  = expected.lower_bound(k);
+         CHECK((it == tree.end()) == (e == expected.end()));
+         if (it != tree.end() && e != expected.end())
+            CHECK(it->key() == e->first);
+         auto* r = tree.find(k);
+         CHECK((r != nullptr) == (expected.count(k) == 1));
+      }
+   }
+
+   // empty the tree, then refill it
+   for (auto& [k, _] : expected) CHECK(tree.erase(k));
+   expected.clear();
+   check_same();
+   CHECK(tree.memory_usage() > 0);
+   for (int i = 0; i < 1000; ++i) {
+      tree.put(std::to_string(i), "x");
+      expected[std::to_string(i)] = "x";
+   }
+   check_same();
+}
+
+template <typename T>
+row_v0 make_row(bool present, const T& obj, std::vector<std::vector<char>>& storage) {
+   storage.push_back(alaio::convert_to_bin(obj));
+   return { present, alaio::input_stream{ storage.back() } };
+}
+
+void test_chain_state() {
+   alaio::chain_state state;
+   std::vector<std::vector<char>> storage;
+   std::string value1 = "value one", value2 = "value two";
+
+   table_delta_v0 tables{ "contract_table" };
+   tables.rows.push_back(make_row(true, contract_table{ contract_table_v0{ name("token"), name("alice"), name("accounts"), name("alice") } }, storage));
+   table_delta_v0 rows{ "contract_row" };
+   for (uint64_t pk : { 3, 1, 2 }) {
+      contract_row_v0 row{ name("token"), name("alice"), name("accounts"), pk, name("alice"), alaio::input_stream{ value1 } };
+      rows.rows.push_back(make_row(true, contract_row{ row }, storage));
+   }
+   contract_row_v0 other_scope{ name("token"), name("bob"), name("accounts"), 1, name("bob"), alaio::input_stream{ value2 } };
+   rows.rows.push_back(make_row(true, contract_row{ other_scope }, storage));
+   table_delta_v0 index{ "contract_index64" };
+   index.rows.push_back(make_row(true, contract_index64{ contract_index64_v0{ name("token"), name("alice"), name("accounts"), 2, name("alice"), 7 } }, storage));
+   index.rows.push_back(make_row(true, contract_index64{ contract_index64_v0{ name("token"), name("alice"), name("accounts"), 1, name("alice"), 9 } }, storage));
+   table_delta_v0 ignored{ "account" };
+   ignored.rows.push_back({ true, alaio::input_stream{ "xx", 2 } });
+
+   auto deltas = alaio::convert_to_bin(std::vector<table_delta>{ tables, rows, index, ignored });
+   state.apply(alaio::input_stream{ deltas });
+   CHECK(state.size() == 1 + 4 + 2);
+   CHECK(state.get_table(name("token"), name("alice"), name("accounts")) == name("alice"));
+   CHECK(!state.get_table(name("token"), name("carol"), name("accounts")));
+
+   auto row = state.get_row(name("token"), name("alice"), name("accounts"), 2);
+   CHECK(row && row->payer == name("alice") && std::string(row->value.pos, row->value.end) == value1);
+   CHECK(!state.get_row(name("token"), name("alice"), name("accounts"), 4));
+
+   std::vector<uint64_t> pks;
+   state.scan_rows(name("token"), name("alice"), name("accounts"), [&](uint64_t pk, const alaio::chain_state::row_view&) {
+      pks.push_back(pk);
+      return true;
+   });
+   CHECK((pks == std::vector<uint64_t>{ 1, 2, 3 }));
+
+   // secondary index entries are ordered by secondary key
+   pks.clear();
+   auto prefix = alaio::chain_state::make_key(name("token"), name("alice"), name("accounts"), alaio::chain_state::kind::index64);
+   state.scan(prefix, [&](std::string_view k, std::string_view) {
+      pks.push_back(uint8_t(k.back()));
+      return true;
+   });
+   CHECK((pks == std::vector<uint64_t>{ 2, 1 }));
+
+   int in_contract = 0;
+   state.scan(alaio::chain_state::make_key(name("token")), [&](std::string_view, std::string_view) { return ++in_contract < 100; });
+   CHECK(in_contract == 7);
+
+   // removals and updates
+   table_delta_v0 update{ "contract_row" };
+   contract_row_v0 changed{ name("token"), name("alice"), name("accounts"), 2, name("bob"), alaio::input_stream{ value2 } };
+   update.rows.push_back(make_row(true, contract_row{ changed }, storage));
+   contract_row_v0 removed{ name("token"), name("alice"), name("accounts"), 3, name("alice"), {} };
+   update.rows.push_back(make_row(false, contract_row{ removed }, storage));
+   state.apply(update);
+   row = state.get_row(name("token"), name("alice"), name("accounts"), 2);
+   CHECK(row && row->payer == name("bob") && std::string(row->value.pos, row->value.end) == value2);
+   CHECK(!state.get_row(name("token"), name("alice"), name("accounts"), 3));
+   CHECK(state.size() == 6);
+}
+
+get_blocks_result_v0 make_block(uint32_t block_num, uint32_t lib, const std::vector<char>& deltas) {
+   get_blocks_result_v0 r;
+   r.this_block = block_position{ block_num, {} };
+   r.last_irreversible = block_position{ lib, {} };
+   r.deltas = alaio::input_stream{ deltas };
+   return r;
+}
+
+std::vector<char> row_deltas(uint64_t pk, bool present, name payer, const std::string& value) {
+   std::vector<std::vector<char>> storage;
+   table_delta_v0 rows{ "contract_row" };
+   contract_row_v0 row{ name("token"), name("alice"), name("accounts"), pk, payer, alaio::input_stream{ value } };
+   rows.rows.push_back(make_row(present, contract_row{ row }, storage));
+   return alaio::convert_to_bin(std::vector<table_delta>{ rows });
+}
+
+void test_undo() {
+   alaio::chain_state state;
+   auto payer_of = [&](uint64_t pk) -> std::optional<name> {
+      auto row = state.get_row(name("token"), name("alice"), name("accounts"), pk);
+      if (!row)
+         return {};
+      return row->payer;
+   };
+
+   auto d1 = row_deltas(1, true, name("alice"), "one");
+   auto d2 = row_deltas(1, true, name("bob"), "two");
+   auto d3 = row_deltas(2, true, name("carol"), "three");
+   auto d3b = row_deltas(1, false, name("bob"), "");
+   state.apply(make_block(1, 0, d1));
+   state.apply(make_block(2, 0, d2));
+   state.apply(make_block(3, 1, d3));
+   CHECK(state.get_undo_log().num_blocks() == 2);
+   CHECK(payer_of(1) == name("bob") && payer_of(2) == name("carol"));
+
+   // fork replacing block 3
+   state.apply(make_block(3, 1, d3b));
+   CHECK(state.get_undo_log().num_blocks() == 2);
+   CHECK(!payer_of(1) && !payer_of(2));
+
+   // fork replacing block 2; block 3 is dropped too
+   state.apply(make_block(2, 1, d3));
+   CHECK(payer_of(1) == name("alice") && payer_of(2) == name("carol"));
+   auto row = state.get_row(name("token"), name("alice"), name("accounts"), 1);
+   CHECK(row && std::string(row->value.pos, row->value.end) == "one");
+   CHECK(state.get_undo_log().last_block() == 2u);
+
+   // irreversible blocks can no longer be reverted
+   state.apply(make_block(3, 2, d2));
+   CHECK(state.get_undo_log().num_blocks() == 1);
+   state.revert(2);
+   CHECK(payer_of(1) == name("alice") && payer_of(2) == name("carol"));
+   state.revert(3);
+   CHECK(payer_of(1) == name("alice"));
+   CHECK(state.get_undo_log().num_blocks() == 0);
+   CHECK(state.size() == 2);
+}
+
+int main() {
+   test_btree();
+   test_chain_state();
+   test_undo();
+   if(error_count) return 1;
+}
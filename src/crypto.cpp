@@ -5,9 +5,13 @@
 #include "../include/alaio/to_json.hpp"
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 
 #include "abiala_ripemd160.hpp"
 
@@ -27,59 +31,123 @@ constexpr auto create_base58_map() {
     std::array<int8_t, 256> base58_map{{0}};
     for (unsigned i = 0; i < base58_map.size(); ++i)
         base58_map[i] = -1;
-    for (unsigned i = 0; i < sizeof(base58_chars); ++i)
+    for (unsigned i = 0; i < sizeof(base58_chars) - 1; ++i)
         base58_map[base58_chars[i]] = i;
     return base58_map;
 }
 
 constexpr auto base58_map = create_base58_map();
 
-template <typename Container>
-void base58_to_binary(Container& result, std::string_view s) {
-    std::size_t offset = result.size();
-    for (auto& src_digit : s) {
-        int carry = base58_map[static_cast<uint8_t>(src_digit)];
-        check(carry >= 0, ::alaio::convert_json_error(::alaio::from_json_error::expected_key));
-        for (std::size_t i = offset; i < result.size(); ++i) {
-            auto& result_byte = result[i];
-            int x = static_cast<uint8_t>(result_byte) * 58 + carry;
-            result_byte = x;
-            carry = x >> 8;
+// Five base58 digits per 32-bit limb operation
+constexpr uint32_t base58_chunk = 58 * 58 * 58 * 58 * 58;
+
+// Scratch space which stays on the stack unless more than N elements are needed
+template <typename T, std::size_t N>
+struct scratch_buffer {
+    T local[N];
+    std::unique_ptr<T[]> heap;
+    T* data;
+
+    explicit scratch_buffer(std::size_t size) : data{local} {
+        if (size > N) {
+            heap.reset(new T[size]);
+            data = heap.get();
+        }
+    }
+};
+
+// Upper bounds of the output sizes of base58_decode and base58_encode
+constexpr std::size_t base58_decoded_max_size(std::size_t size) { return size + 1; }
+constexpr std::size_t base58_encoded_max_size(std::size_t size) { return size * 138 / 100 + 6; }
+
+// Decodes s into dest, which must hold base58_decoded_max_size(s.size()) bytes, and returns the decoded size. The value
+// is kept as little-endian 32-bit limbs and takes five digits per multiply-add pass.
+std::size_t base58_decode(std::string_view s, char* dest) {
+    std::size_t zeros = 0;
+    while (zeros < s.size() && s[zeros] == '1')
+        ++zeros;
+    scratch_buffer<uint32_t, 32> limbs(s.size() / 5 + 2);
+    std::size_t num_limbs = 0;
+    for (std::size_t pos = zeros; pos < s.size();) {
+        std::size_t n = std::min<std::size_t>(5, s.size() - pos);
+        uint32_t chunk = 0, mul = 1;
+        for (std::size_t i = 0; i < n; ++i, ++pos) {
+            int digit = base58_map[static_cast<uint8_t>(s[pos])];
+            check(digit >= 0, ::alaio::convert_json_error(::alaio::from_json_error::expected_key));
+            chunk = chunk * 58 + digit;
+            mul *= 58;
+        }
+        uint64_t carry = chunk;
+        for (std::size_t i = 0; i < num_limbs; ++i) {
+            uint64_t x = uint64_t(limbs.data[i]) * mul + carry;
+            limbs.data[i] = uint32_t(x);
+            carry = x >> 32;
         }
         if (carry)
-            result.push_back(static_cast<uint8_t>(carry));
+            limbs.data[num_limbs++] = uint32_t(carry);
     }
-    for (auto& src_digit : s)
-        if (src_digit == '1')
-            result.push_back(0);
-        else
-            break;
-    std::reverse(result.begin() + offset, result.end());
+    char* out = dest;
+    memset(out, 0, zeros);
+    out += zeros;
+    for (std::size_t i = num_limbs; i-- > 0;) {
+        uint32_t limb = limbs.data[i];
+        int bytes = i + 1 == num_limbs ? (39 - __builtin_clz(limb)) / 8 : 4;
+        while (bytes--)
+            *out++ = char(limb >> (bytes * 8));
+    }
+    return out - dest;
 }
 
-template <typename Container>
-std::string binary_to_base58(const Container& bin) {
-    std::string result("");
-    for (auto byte : bin) {
-        static_assert(sizeof(byte) == 1);
-        int carry = static_cast<uint8_t>(byte);
-        for (auto& result_digit : result) {
-            int x = (base58_map[result_digit] << 8) + carry;
-            result_digit = base58_chars[x % 58];
-            carry = x / 58;
+// Encodes [data, data + size) into dest, which must hold base58_encoded_max_size(size) characters, and returns the
+// encoded size. Each pass divides the big-endian 32-bit limbs by 58^5.
+std::size_t base58_encode(const char* data, std::size_t size, char* dest) {
+    std::size_t zeros = 0;
+    while (zeros < size && data[zeros] == 0)
+        ++zeros;
+    auto* bytes = reinterpret_cast<const uint8_t*>(data) + zeros;
+    std::size_t n = size - zeros;
+    std::size_t num_limbs = (n + 3) / 4;
+    scratch_buffer<uint32_t, 32> limbs(num_limbs);
+    for (std::size_t i = 0, b = 0; i < num_limbs; ++i) {
+        uint32_t limb = 0;
+        for (std::size_t end = n - (num_limbs - 1 - i) * 4; b < end; ++b)
+            limb = (limb << 8) | bytes[b];
+        limbs.data[i] = limb;
+    }
+    char* out = dest;
+    for (std::size_t start = 0; start < num_limbs;) {
+        uint64_t rem = 0;
+        for (std::size_t i = start; i < num_limbs; ++i) {
+            uint64_t x = (rem << 32) | limbs.data[i];
+            limbs.data[i] = uint32_t(x / base58_chunk);
+            rem = x % base58_chunk;
         }
-        while (carry) {
-            result.push_back(base58_chars[carry % 58]);
-            carry = carry / 58;
+        while (start < num_limbs && !limbs.data[start])
+            ++start;
+        for (int i = 0; i < 5; ++i) {
+            *out++ = base58_chars[rem % 58];
+            rem /= 58;
         }
     }
-    for (auto byte : bin)
-        if (byte)
-            break;
-        else
-            result.push_back('1');
-    std::reverse(result.begin(), result.end());
-    return result;
+    // The most significant chunk is zero padded
+    while (out != dest && out[-1] == '1')
+        --out;
+    for (std::size_t i = 0; i < zeros; ++i)
+        *out++ = '1';
+    std::reverse(dest, out);
+    return out - dest;
+}
+
+template <typename Container>
+void base58_to_binary(Container& result, std::string_view s) {
+    std::size_t offset = result.size();
+    result.resize(offset + base58_decoded_max_size(s.size()));
+    result.resize(offset + base58_decode(s, result.data() + offset));
+}
+
+std::string binary_to_base58(std::string_view bin) {
+    scratch_buffer<char, 128> buf(base58_encoded_max_size(bin.size()));
+    return std::string(buf.data, base58_encode(bin.data(), bin.size(), buf.data));
 }
 
 template <typename... Container>
@@ -95,26 +163,98 @@ std::array<unsigned char, 20> digest_suffix_ripemd160(const Container&... data)
 
 template <typename Key>
 Key string_to_key(std::string_view s, key_type type, std::string_view suffix) {
-    std::vector<char> whole;
-    whole.push_back(uint8_t{type});
-    base58_to_binary(whole, s);
-    check(whole.size() > 5, convert_json_error(alaio::from_json_error::expected_key));
-    auto ripe_digest = digest_suffix_ripemd160(std::string_view(whole.data() + 1, whole.size() - 5), suffix);
-    check(memcmp(ripe_digest.data(), whole.data() + whole.size() - 4, 4) == 0,
+    scratch_buffer<char, 128> whole(1 + base58_decoded_max_size(s.size()));
+    whole.data[0] = type;
+    std::size_t size = 1 + base58_decode(s, whole.data + 1);
+    check(size > 5, convert_json_error(alaio::from_json_error::expected_key));
+    auto ripe_digest = digest_suffix_ripemd160(std::string_view(whole.data + 1, size - 5), suffix);
+    check(memcmp(ripe_digest.data(), whole.data + size - 4, 4) == 0,
           convert_json_error(from_json_error::expected_key));
-    whole.erase(whole.end() - 4, whole.end());
-    return convert_from_bin<Key>(whole);
+    Key result;
+    input_stream stream{whole.data, size - 4};
+    from_bin(result, stream);
+    return result;
 }
 
 template <typename Key>
-std::string key_to_string(const Key& key, std::string_view suffix, const char* prefix) {
-    auto whole = convert_to_bin(key);
-    auto ripe_digest = digest_suffix_ripemd160(std::string_view(whole.data() + 1, whole.size() - 1), suffix);
-    whole.insert(whole.end(), ripe_digest.data(), ripe_digest.data() + 4);
-    return prefix + binary_to_base58(std::string_view(whole.data() + 1, whole.size() - 1));
+std::string key_to_string(const Key& key, std::string_view suffix, std::string_view prefix) {
+    size_stream ss;
+    to_bin(key, ss);
+    scratch_buffer<char, 128> whole(ss.size + 4);
+    fixed_buf_stream fbs{whole.data, ss.size};
+    to_bin(key, fbs);
+    auto ripe_digest = digest_suffix_ripemd160(std::string_view(whole.data + 1, ss.size - 1), suffix);
+    memcpy(whole.data + ss.size, ripe_digest.data(), 4);
+    scratch_buffer<char, 160> buf(prefix.size() + base58_encoded_max_size(ss.size + 3));
+    memcpy(buf.data, prefix.data(), prefix.size());
+    auto size = prefix.size() + base58_encode(whole.data + 1, ss.size + 3, buf.data + prefix.size());
+    return std::string(buf.data, size);
+}
+// Batch form of key_to_string for public keys and signatures, whose variant index selects K1, R1 or WA. The
+// checksums are computed together by ripemd160_many.
+template <typename Key>
+std::vector<std::string> keys_to_string(const std::vector<Key>& keys, std::string_view prefix, from_json_error error) {
+    static constexpr std::string_view suffixes[] = {"K1", "R1", "WA"};
+    // each key's serialized form followed by 4 bytes holding first its suffix, then its checksum
+    std::vector<std::size_t> offsets(keys.size() + 1);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        check(keys[i].index() < 3, convert_json_error(error));
+        size_stream ss;
+        to_bin(keys[i], ss);
+        offsets[i + 1] = offsets[i] + ss.size + 4;
+    }
+    std::vector<char> whole(offsets.back());
+    std::vector<std::string_view> messages(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        std::size_t size = offsets[i + 1] - offsets[i] - 4;
+        char* data = whole.data() + offsets[i];
+        fixed_buf_stream fbs{data, size};
+        to_bin(keys[i], fbs);
+        memcpy(data + size, suffixes[keys[i].index()].data(), 2);
+        messages[i] = {data + 1, size + 1};
+    }
+    std::vector<unsigned char> digests(20 * keys.size());
+    abiala_ripemd160::ripemd160_many(messages.data(), messages.size(), digests.data());
+
+    std::vector<std::string> result(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        std::size_t size = offsets[i + 1] - offsets[i] - 4;
+        char* data = whole.data() + offsets[i];
+        memcpy(data + size, digests.data() + 20 * i, 4);
+        auto& s = result[i];
+        s.resize(prefix.size() + 3 + base58_encoded_max_size(size + 3));
+        memcpy(s.data(), prefix.data(), prefix.size());
+        memcpy(s.data() + prefix.size(), suffixes[keys[i].index()].data(), 2);
+        s[prefix.size() + 2] = '_';
+        s.resize(prefix.size() + 3 + base58_encode(data + 1, size + 3, s.data() + prefix.size() + 3));
+    }
+    return result;
+}
+
+// Frees one entry of a full cache map before inserting hash, unless hash is already there to be replaced. The victim
+// is the first entry at or after hash's bucket, which for well-mixed hashes amounts to random replacement.
+template <typename Map>
+void make_room(Map& map, std::size_t hash) {
+    if (map.count(hash))
+        return;
+    auto n = map.bucket_count();
+    for (auto b = hash % n;; b = (b + 1) % n) {
+        if (map.bucket_size(b)) {
+            map.erase(map.begin(b)->first);
+            return;
+        }
+    }
 }
 } // namespace
 
+std::vector<std::string> alaio::public_keys_to_string(const std::vector<public_key>& keys) {
+    return keys_to_string(keys, "PUB_", from_json_error::expected_public_key);
+}
+
+std::vector<std::string> alaio::signatures_to_string(const std::vector<signature>& signatures) {
+    return keys_to_string(signatures, "SIG_", from_json_error::expected_signature);
+}
+
 std::string alaio::public_key_to_string(const public_key& key) {
     if (key.index() == key_type::k1) {
         return key_to_string(key, "K1", "PUB_K1_");
@@ -164,12 +304,14 @@ private_key alaio::private_key_from_string(std::string_view s) {
         check(false, convert_json_error(from_json_error::expected_private_key));
         __builtin_unreachable();
     } else {
-        std::vector<char> whole;
-        base58_to_binary(whole, s);
-        check(whole.size() >= 5, convert_json_error(from_json_error::expected_private_key));
-        whole[0] = key_type::k1;
-        whole.erase(whole.end() - 4, whole.end());
-        return convert_from_bin<private_key>(whole);
+        scratch_buffer<char, 128> whole(base58_decoded_max_size(s.size()));
+        std::size_t size = base58_decode(s, whole.data);
+        check(size >= 5, convert_json_error(from_json_error::expected_private_key));
+        whole.data[0] = key_type::k1;
+        private_key result;
+        input_stream stream{whole.data, size - 4};
+        from_bin(result, stream);
+        return result;
     }
 }
 
@@ -199,6 +341,93 @@ signature alaio::signature_from_string(std::string_view s) {
     }
 }
 
+struct alaio::key_string_cache::shard {
+    std::mutex mutex;
+    // Entries are found by hash and confirmed by comparing the full input; a colliding entry is replaced, and a full
+    // map evicts one entry per insert
+    std::unordered_map<std::size_t, std::pair<std::string, std::string>> strings;
+    std::unordered_map<std::size_t, std::pair<std::string, public_key>> keys;
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+};
+
+alaio::key_string_cache::key_string_cache(std::size_t capacity)
+    : shard_capacity{std::max<std::size_t>(1, capacity / num_shards)}, shards{new shard[num_shards]} {}
+
+alaio::key_string_cache::~key_string_cache() = default;
+
+std::string alaio::key_string_cache::to_string(const public_key& key) {
+    size_stream ss;
+    to_bin(key, ss);
+    scratch_buffer<char, 64> buf(ss.size);
+    fixed_buf_stream fbs{buf.data, ss.size};
+    to_bin(key, fbs);
+    std::string_view bin{buf.data, ss.size};
+    auto hash = std::hash<std::string_view>{}(bin);
+    auto& sh = shards[hash % num_shards];
+    {
+        std::lock_guard lock{sh.mutex};
+        auto it = sh.strings.find(hash);
+        if (it != sh.strings.end() && it->second.first == bin) {
+            sh.hits.fetch_add(1, std::memory_order_relaxed);
+            return it->second.second;
+        }
+    }
+    sh.misses.fetch_add(1, std::memory_order_relaxed);
+    auto result = public_key_to_string(key);
+    std::lock_guard lock{sh.mutex};
+    if (sh.strings.size() >= shard_capacity)
+        make_room(sh.strings, hash);
+    sh.strings.insert_or_assign(hash, std::pair{std::string(bin), result});
+    return result;
+}
+
+public_key alaio::key_string_cache::from_string(std::string_view s) {
+    auto hash = std::hash<std::string_view>{}(s);
+    auto& sh = shards[hash % num_shards];
+    {
+        std::lock_guard lock{sh.mutex};
+        auto it = sh.keys.find(hash);
+        if (it != sh.keys.end() && it->second.first == s) {
+            sh.hits.fetch_add(1, std::memory_order_relaxed);
+            return it->second.second;
+        }
+    }
+    sh.misses.fetch_add(1, std::memory_order_relaxed);
+    auto result = public_key_from_string(s);
+    std::lock_guard lock{sh.mutex};
+    if (sh.keys.size() >= shard_capacity)
+        make_room(sh.keys, hash);
+    sh.keys.insert_or_assign(hash, std::pair{std::string(s), result});
+    return result;
+}
+
+uint64_t alaio::key_string_cache::hits() const {
+    uint64_t result = 0;
+    for (std::size_t i = 0; i < num_shards; ++i)
+        result += shards[i].hits.load(std::memory_order_relaxed);
+    return result;
+}
+
+uint64_t alaio::key_string_cache::misses() const {
+    uint64_t result = 0;
+    for (std::size_t i = 0; i < num_shards; ++i)
+        result += shards[i].misses.load(std::memory_order_relaxed);
+    return result;
+}
+
+namespace {
+std::atomic<key_string_cache*> installed_key_string_cache{nullptr};
+}
+
+void alaio::set_key_string_cache(key_string_cache* cache) {
+    installed_key_string_cache.store(cache, std::memory_order_release);
+}
+
+key_string_cache* alaio::get_key_string_cache() {
+    return installed_key_string_cache.load(std::memory_order_acquire);
+}
+
 namespace alaio {
 std::string to_base58(const char* d, size_t s) { return binary_to_base58(std::string_view(d, s)); }
 
@@ -41,6 +41,12 @@ struct struct_type {
 ALAIO_REFLECT(struct_type, v, o, va);
 ALAIO_COMPARE(struct_type);
 
+struct one_byte_struct {
+   uint8_t v;
+};
+ALAIO_REFLECT(one_byte_struct, v);
+ALAIO_COMPARE(one_byte_struct);
+
 // Verifies that the ordering of keys is the same as the ordering of the original objects
 template<typename T>
 void test_key(const T& x, const T& y) {
@@ -210,6 +216,13 @@ void test_compare() {
    test_key(struct_type{{0, 1, 2}, {}, {0}}, struct_type{{}, {}, {0.0}});
    test_key(struct_type{{0, 1, 2}, {}, {0}}, struct_type{{0, 1, 2}, 0, {0}});
    test_key(struct_type{{0, 1, 2}, 0, {0}}, struct_type{{0, 1, 2}, 0, {0.0}});
+
+   // only one-byte scalars drop the presence byte of an optional
+   CHECK(alaio::convert_to_key(std::optional<one_byte_struct>{{5}}) == (std::vector<char>{1, 5}));
+   CHECK(alaio::convert_to_key(std::optional<one_byte_struct>{}) == (std::vector<char>{0}));
+   CHECK(alaio::convert_to_key(std::optional<uint8_t>{5}) == (std::vector<char>{5}));
+   test_key(std::optional<one_byte_struct>{}, std::optional<one_byte_struct>{{0}});
+   test_key(std::optional<one_byte_struct>{{0}}, std::optional<one_byte_struct>{{1}});
 }
 
 int main() {
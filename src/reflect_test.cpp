@@ -1,5 +1,6 @@
 #include <alaio/reflection.hpp>
 #include <alaio/for_each_field.hpp>
+#include <alaio/stream.hpp>
 #include <cstdio>
 
 int error_count;
@@ -18,6 +19,53 @@ struct fn {
 };
 ALAIO_REFLECT(fn, test);
 
+struct packed {
+   uint64_t a = 0;
+   uint32_t b = 0;
+   uint16_t c = 0;
+   uint8_t  d = 0;
+   bool     e = false;
+};
+ALAIO_REFLECT(packed, a, b, c, d, e);
+
+struct padded {
+   uint8_t  a = 0;
+   uint32_t b = 0;
+};
+ALAIO_REFLECT(padded, a, b);
+
+struct reordered {
+   uint32_t a = 0;
+   uint32_t b = 0;
+};
+ALAIO_REFLECT(reordered, b, a);
+
+struct partial {
+   uint32_t a = 0;
+   uint32_t b = 0;
+};
+ALAIO_REFLECT(partial, a);
+
+struct nested {
+   packed                 p;
+   std::array<packed, 2>  arr;
+};
+ALAIO_REFLECT(nested, p, arr);
+
+struct custom {
+   uint32_t a = 0;
+};
+ALAIO_REFLECT(custom, a);
+constexpr bool has_custom_serialization(custom*) { return true; }
+
+static_assert(alaio::has_bitwise_serialization<packed>());
+static_assert(alaio::has_bitwise_serialization<nested>());
+static_assert(!alaio::has_bitwise_serialization<padded>());
+static_assert(!alaio::has_bitwise_serialization<reordered>());
+static_assert(!alaio::has_bitwise_serialization<partial>());
+static_assert(!alaio::has_bitwise_serialization<custom>());
+static_assert(!alaio::has_bitwise_serialization<fn>());
+
 int main() {
    int counter = 0;
    alaio::for_each_field<fn>([&](const char* name, auto method) { ++counter; });
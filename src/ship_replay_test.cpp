@@ -0,0 +1,183 @@
+#include <alaio/ship_replay.hpp>
+#include <alaio/ship_replay_summary.hpp>
+
+#include <cstdio>
+#include <string>
+
+int error_count;
+
+void report_error(const char* assertion, const char* file, int line) {
+    if(error_count <= 20) {
+       printf("%s:%d: failed %s\n", file, line, assertion);
+    }
+    ++error_count;
+}
+
+#define CHECK(...) do { if(__VA_ARGS__) {} else { report_error(#__VA_ARGS__, __FILE__, __LINE__); } } while(0)
+
+using namespace alaio::ship_protocol;
+
+std::string block_data(uint32_t block_num, char fork) { return std::string(3, fork) + std::to_string(block_num); }
+
+void append_message(const std::string& path, const get_blocks_result_v0& r) {
+   auto bin = alaio::convert_to_bin(result{ r });
+   uint32_t size = bin.size();
+   std::FILE* f = std::fopen(path.c_str(), "ab");
+   std::fwrite(&size, sizeof(size), 1, f);
+   std::fwrite(bin.data(), 1, bin.size(), f);
+   std::fclose(f);
+}
+
+void append_block(const std::string& path, uint32_t block_num, char fork) {
+   std::string block = block_data(block_num, fork);
+   get_blocks_result_v0 r;
+   r.head = { block_num, {} };
+   r.this_block = block_position{ block_num, {} };
+   r.block = alaio::input_stream{ block.data(), block.size() };
+   r.deltas = alaio::input_stream{ "dd", 2 };
+   append_message(path, r);
+}
+
+std::string view(const std::optional<alaio::input_stream>& s) { return s ? std::string(s->pos, s->end) : "<none>"; }
+
+void test_replay(const std::string& path) {
+   std::remove(path.c_str());
+   std::remove((path + ".index").c_str());
+   for (uint32_t b = 5; b < 10; ++b) append_block(path, b, 'a');
+   // a fork replacing blocks 8 and 9
+   append_block(path, 8, 'b');
+   append_block(path, 9, 'b');
+
+   {
+      alaio::ship_replay_file file(path);
+      CHECK(file.entries().size() == 5);
+      CHECK(file.entries().front().block_num == 5);
+      CHECK(file.entries().back().block_num == 9);
+      CHECK(!file.find(4));
+      CHECK(!file.find(10));
+      auto msg = file.find(7);
+      CHECK(msg && view(msg->result.block) == block_data(7, 'a'));
+      CHECK(msg && view(msg->result.deltas) == "dd");
+      CHECK(msg && view(msg->result.traces) == "<none>");
+      msg = file.find(9);
+      CHECK(msg && view(msg->result.block) == block_data(9, 'b'));
+
+      std::vector<uint32_t> seen;
+      file.for_each(6, 9, [&](const alaio::ship_replay_message& m) {
+         seen.push_back(m.result.this_block->block_num);
+         CHECK(view(m.result.block) == block_data(m.result.this_block->block_num, m.result.this_block->block_num < 8 ? 'a' : 'b'));
+      });
+      CHECK((seen == std::vector<uint32_t>{ 6, 7, 8 }));
+   }
+
+   // the saved index is extended with blocks appended later
+   append_block(path, 10, 'a');
+   append_block(path, 9, 'c');
+   {
+      alaio::ship_replay_file file(path);
+      CHECK(file.entries().size() == 6);
+      auto msg = file.find(9);
+      CHECK(msg && view(msg->result.block) == block_data(9, 'c'));
+      msg = file.find(10);
+      CHECK(msg && view(msg->result.block) == block_data(10, 'a'));
+      file.prefetch(0, file.entries().size());
+   }
+
+   // a partially written message is left out of the index
+   {
+      std::FILE* f = std::fopen(path.c_str(), "ab");
+      uint32_t size = 100;
+      std::fwrite(&size, sizeof(size), 1, f);
+      std::fwrite("xx", 1, 2, f);
+      std::fclose(f);
+      alaio::ship_replay_file file(path, false);
+      CHECK(file.entries().size() == 6);
+   }
+
+   std::remove(path.c_str());
+   std::remove((path + ".index").c_str());
+}
+
+void append_block(const std::string& path, uint32_t block_num, std::vector<action_trace_v1> actions,
+                  std::vector<alaio::name> row_codes) {
+   transaction_trace_v0 trace;
+   for (auto& a : actions) trace.action_traces.push_back(a);
+   table_delta_v0 delta{ "contract_row" };
+   std::vector<std::vector<char>> rows;
+   for (auto code : row_codes) {
+      contract_row_v0 row;
+      row.code = code;
+      rows.push_back(alaio::convert_to_bin(contract_row{ row }));
+   }
+   for (auto& row : rows) delta.rows.push_back({ true, alaio::input_stream{ row } });
+   auto traces = alaio::convert_to_bin(std::vector<transaction_trace>{ trace });
+   auto deltas = alaio::convert_to_bin(std::vector<table_delta>{ delta, table_delta_v0{ "account" } });
+
+   get_blocks_result_v0 r;
+   r.this_block = block_position{ block_num, {} };
+   if (!actions.empty())
+      r.traces = alaio::input_stream{ traces };
+   r.deltas = alaio::input_stream{ deltas };
+   append_message(path, r);
+}
+
+action_trace_v1 make_action(const char* receiver, const char* account, const char* name) {
+   action_trace_v1 a;
+   a.receiver = alaio::name(receiver);
+   a.act.account = alaio::name(account);
+   a.act.name = alaio::name(name);
+   return a;
+}
+
+void test_summary(const std::string& path) {
+   using alaio::name;
+   std::remove(path.c_str());
+   std::remove((path + ".index").c_str());
+   std::remove((path + ".summary").c_str());
+   append_block(path, 1, { make_action("alice", "alaio.token", "transfer") }, {});
+   append_block(path, 2, {}, {});
+   append_block(path, 3, {}, { name("bob") });
+   append_block(path, 4, { make_action("carol", "carol", "hi"), make_action("dave", "carol", "hi") }, {});
+
+   std::vector<uint32_t> seen;
+   auto record = [&](const alaio::ship_replay_message& m) { seen.push_back(m.result.this_block->block_num); };
+   {
+      alaio::ship_replay_file file(path);
+      alaio::ship_replay_summary summary(file);
+      CHECK(summary.may_contain(1, name("alice")));
+      CHECK(summary.may_contain(1, name("alaio.token")));
+      CHECK(summary.may_contain(1, name("transfer")));
+      CHECK(!summary.may_contain(1, name("bob")));
+      CHECK(!summary.may_contain(2, name("alice")));
+      CHECK(summary.may_contain(3, name("bob")));
+      CHECK(summary.may_contain(4, name("dave")));
+      CHECK(summary.may_contain_any(4, { name("bob"), name("carol") }));
+      CHECK(summary.may_contain(5, name("bob"))); // not summarized
+      summary.for_each(file, 0, 10, { name("bob"), name("dave") }, record);
+      CHECK((seen == std::vector<uint32_t>{ 3, 4 }));
+   }
+
+   // blocks replaced by a fork are summarized again when the summary is loaded
+   append_block(path, 3, {}, { name("erin") });
+   {
+      alaio::ship_replay_file file(path);
+      alaio::ship_replay_summary summary(file);
+      CHECK(summary.get_data().entries.size() == 4);
+      CHECK(!summary.may_contain(3, name("bob")));
+      CHECK(summary.may_contain(3, name("erin")));
+      CHECK(summary.may_contain(1, name("alice")));
+      seen.clear();
+      summary.for_each(file, 2, 10, { name("alice"), name("erin") }, record);
+      CHECK((seen == std::vector<uint32_t>{ 3 }));
+   }
+
+   std::remove(path.c_str());
+   std::remove((path + ".index").c_str());
+   std::remove((path + ".summary").c_str());
+}
+
+int main() {
+   test_replay("ship_replay_test.bin");
+   test_summary("ship_replay_summary_test.bin");
+   if(error_count) return 1;
+}
@@ -11,6 +11,8 @@
 #include <alaio/float.hpp>
 #include <alaio/varint.hpp>
 #include <alaio/abi.hpp>
+#include <alaio/scatter_stream.hpp>
+#include "abiala_numeric.hpp"
 
 int error_count;
 
@@ -128,12 +130,437 @@ struct struct_type {
 ALAIO_REFLECT(struct_type, v, o, va);
 ALAIO_COMPARE(struct_type);
 
+struct string_view_struct {
+   std::string_view s;
+   std::optional<std::string_view> o;
+};
+ALAIO_REFLECT(string_view_struct, s, o);
+ALAIO_COMPARE(string_view_struct);
+
+struct forwarded_struct {
+   uint32_t            block_num = 0;
+   alaio::input_stream traces    = {};
+   std::string         note      = {};
+   alaio::bytes        deltas    = {};
+};
+ALAIO_REFLECT(forwarded_struct, block_num, traces, note, deltas);
+
+// Keys may come in any order; unknown keys are skipped
+void test_from_json_key_order() {
+   std::string json = R"({"zz":[1,{"v":[]}],"va":["float64",2.5],"o":7,"x":{},"v":[3,4]})";
+   alaio::json_token_stream stream(json.data());
+   struct_type value;
+   from_json(value, stream);
+   CHECK(value == struct_type{{3,4},7,2.5});
+}
+
+void test_to_json_keys() {
+   struct_type value{{1,2},3,4};
+   CHECK(alaio::convert_to_json(value) == R"({"v":[1,2],"o":3,"va":["int32",4]})");
+   CHECK(alaio::format_json(value) == "{\n    \"v\": [\n        1,\n        2\n    ],\n    \"o\": 3,\n    \"va\": [\n        \"int32\",\n        4\n    ]\n}");
+}
+
+void test_number_format() {
+   CHECK(alaio::convert_to_json(uint64_t(-1)) == R"("18446744073709551615")");
+   CHECK(alaio::convert_to_json(int64_t(-100)) == R"("-100")");
+   CHECK(alaio::convert_to_json(std::numeric_limits<int128>::min()) == R"("-170141183460469231731687303715884105728")");
+   CHECK(alaio::convert_to_json(uint128(-1)) == R"("340282366920938463463374607431768211455")");
+   CHECK(alaio::convert_to_json(uint128(10'000'000'000'000'000'000ull) * 10'000'000'000'000'000'000ull) ==
+         R"("100000000000000000000000000000000000000")");
+   CHECK(alaio::convert_to_json(0.1f) == "0.1");
+   CHECK(alaio::convert_to_json(0.1) == "0.1");
+   CHECK(alaio::convert_to_json(std::numeric_limits<float>::max()) == "3.4028235e+38");
+   // laid out like javascript's Number.prototype.toString
+   CHECK(alaio::convert_to_json(100000.0) == "100000");
+   CHECK(alaio::convert_to_json(100000.f) == "100000");
+   CHECK(alaio::convert_to_json(0.0001) == "0.0001");
+   CHECK(alaio::convert_to_json(0.000001) == "0.000001");
+   CHECK(alaio::convert_to_json(1e-7) == "1e-7");
+   CHECK(alaio::convert_to_json(1e-7f) == "1e-7");
+   CHECK(alaio::convert_to_json(-123.456) == "-123.456");
+   CHECK(alaio::convert_to_json(1e20) == "100000000000000000000");
+   CHECK(alaio::convert_to_json(1e21) == "1e+21");
+   CHECK(alaio::convert_to_json(-1.5e300) == "-1.5e+300");
+   CHECK(alaio::convert_to_json(5e-324) == "5e-324");
+   CHECK(alaio::convert_to_json(-0.0000012345678901234567) == "-0.0000012345678901234567");
+   CHECK(alaio::convert_to_json(0.0) == "0");
+   auto tst = [](uint8_t precision) { return uint64_t('T' | 'S' << 8 | 'T' << 16) << 8 | precision; };
+   CHECK(alaio::asset_to_string(-12345, tst(4)) == "-1.2345 TST");
+   CHECK(alaio::asset_to_string(5, tst(3)) == "0.005 TST");
+   CHECK(alaio::asset_to_string(std::numeric_limits<int64_t>::min(), tst(0)) == "-9223372036854775808 TST");
+}
+
+void test_decimal_binary() {
+   auto decimal = [](uint128 value) {
+      std::string result;
+      do {
+         result.insert(result.begin(), char('0' + int(value % 10)));
+         value /= 10;
+      } while(value);
+      return result;
+   };
+   auto bytes_of = [](uint128 value) {
+      std::array<uint8_t, 16> result;
+      memcpy(result.data(), &value, sizeof(value));
+      return result;
+   };
+   constexpr uint128 e18 = 1'000'000'000'000'000'000ull;
+   for(uint128 value : {uint128(0), uint128(999'999'999), uint128(1'000'000'000), uint128(1'000'000'001), e18,
+                        e18 * 10, e18 * e18 + 1, uint128(-1)}) {
+      std::array<uint8_t, 16> bin;
+      abiala::decimal_to_binary(bin, decimal(value));
+      CHECK(bin == bytes_of(value));
+      CHECK(abiala::binary_to_decimal(bytes_of(value)) == decimal(value));
+   }
+
+   // int128 minimum: its magnitude is parsed, then negated
+   auto min = std::numeric_limits<int128>::min();
+   std::array<uint8_t, 16> bin;
+   abiala::decimal_to_binary(bin, "170141183460469231731687303715884105728");
+   abiala::negate(bin);
+   CHECK(abiala::is_negative(bin) && bin == bytes_of(uint128(min)));
+   CHECK(abiala::binary_to_decimal(bytes_of(uint128(min))) == "170141183460469231731687303715884105728");
+   CHECK(abiala::binary_to_decimal(std::array<uint8_t, 8>{}) == "0");
+
+   auto error = [&](std::string_view s) -> std::string {
+      try {
+         abiala::decimal_to_binary(bin, s);
+      } catch(std::exception& e) {
+         return e.what();
+      }
+      return "";
+   };
+   auto out_of_range = std::string(alaio::convert_json_error(alaio::from_json_error::number_out_of_range));
+   auto expected_int = std::string(alaio::convert_json_error(alaio::from_json_error::expected_int));
+   CHECK(error("340282366920938463463374607431768211456") == out_of_range);
+   CHECK(error("12a4") == expected_int);
+   CHECK(error("1234567890123456789012345678901234567890x") == out_of_range);
+}
+
+void test_asset_codec() {
+   auto tst = [](uint8_t precision) { return uint64_t('T' | 'S' << 8 | 'T' << 16) << 8 | precision; };
+   for(int precision : {0, 1, 4, 8, 18, 19, 20, 25, 255}) {
+      for(int64_t amount : {int64_t(0), int64_t(7), int64_t(-123456789), std::numeric_limits<int64_t>::max(),
+                            std::numeric_limits<int64_t>::min()}) {
+         auto str = alaio::asset_to_string(amount, tst(precision));
+         int64_t parsed_amount = 0;
+         uint64_t parsed_symbol = 0;
+         CHECK(alaio::string_to_asset(parsed_amount, parsed_symbol, str.data(), str.data() + str.size()));
+         CHECK(parsed_amount == amount && parsed_symbol == tst(precision));
+      }
+   }
+   CHECK(alaio::asset_to_string(10000, tst(4)) == "1.0000 TST");
+   CHECK(alaio::asset_to_string(-5, tst(20)) == "-0.00000000000000000005 TST");
+   CHECK(alaio::convert_to_json(alaio::asset{12345, alaio::symbol{"ALA", 4}}) == "\"1.2345 ALA\"");
+   alaio::asset odd;
+   odd.amount = 1;
+   odd.symbol = alaio::symbol{uint64_t('"') << 8};
+   CHECK(alaio::convert_to_json(odd) == R"("1 \"")");
+
+   int64_t amount;
+   uint64_t sym;
+   auto parse = [&](std::string_view s) { return alaio::string_to_asset(amount, sym, s.data(), s.data() + s.size()); };
+   CHECK(parse("9223372036854775807 A") && amount == std::numeric_limits<int64_t>::max());
+   CHECK(parse("-922337203685477580.8 A") && amount == std::numeric_limits<int64_t>::min() && (sym & 0xff) == 1);
+   CHECK(!parse("9223372036854775808 A"));
+   CHECK(!parse("-9223372036854775809 A"));
+   CHECK(!parse("99999999999999999999 A"));
+   CHECK(!parse("1.000000000000000000000 A"));
+   CHECK(parse("0." + std::string(255, '0') + " A") && amount == 0 && (sym & 0xff) == 255);
+   CHECK(!parse("0." + std::string(256, '0') + " A"));
+}
+
+template<typename T>
+bool parse_json(T& value, std::string json) {
+   try {
+      alaio::json_token_stream stream(json.data());
+      from_json(value, stream);
+      return true;
+   } catch(std::exception&) {
+      return false;
+   }
+}
+
+void test_number_parse() {
+   uint64_t u64 = 0;
+   CHECK(parse_json(u64, R"("18446744073709551615")") && u64 == 18446744073709551615ull);
+   CHECK(parse_json(u64, R"("000000000000000000000000000042")") && u64 == 42);
+   CHECK(!parse_json(u64, R"("18446744073709551616")"));
+   CHECK(!parse_json(u64, R"("1234567890x")"));
+   CHECK(!parse_json(u64, R"("")"));
+   int64_t i64 = 0;
+   CHECK(parse_json(i64, R"("-9223372036854775808")") && i64 == std::numeric_limits<int64_t>::min());
+   CHECK(!parse_json(i64, R"("-9223372036854775809")"));
+   CHECK(!parse_json(i64, R"("-")"));
+   int8_t i8 = 0;
+   CHECK(parse_json(i8, "-128") && i8 == -128);
+   CHECK(!parse_json(i8, "128"));
+   int128 i128 = 0;
+   CHECK(parse_json(i128, R"("-170141183460469231731687303715884105728")") && i128 == std::numeric_limits<int128>::min());
+   CHECK(!parse_json(i128, R"("170141183460469231731687303715884105728")"));
+   double d = 0;
+   CHECK(parse_json(d, "0.1") && d == 0.1);
+   CHECK(parse_json(d, "-2.5e-3") && d == -2.5e-3);
+   CHECK(!parse_json(d, R"("1.5x")"));
+   float f = 0;
+   CHECK(parse_json(f, "0.1") && f == 0.1f);
+   CHECK(!parse_json(f, "1e39"));
+}
+
+void test_base58() {
+   std::string bin("\0\0\x01\xff\x80\x00\x7f", 7);
+   CHECK(alaio::to_base58(bin.data(), bin.size()) == "11E5Kfga");
+   auto decoded = alaio::from_base58("11E5Kfga");
+   CHECK(std::string(decoded.data(), decoded.size()) == bin);
+   CHECK(alaio::to_base58("", 0).empty());
+   CHECK(alaio::from_base58("111").size() == 3);
+}
+
+void test_batch_key_strings() {
+   std::vector<public_key> keys;
+   std::vector<signature> sigs;
+   for(int i = 0; i < 11; ++i) {
+      alaio::ecc_public_key k{};
+      alaio::ecc_signature s{};
+      for(std::size_t j = 0; j < k.size(); ++j) k[j] = char(i * 31 + j);
+      for(std::size_t j = 0; j < s.size(); ++j) s[j] = char(i * 17 + j * 3);
+      keys.emplace_back(std::in_place_index<1>, k);
+      sigs.push_back(signature{std::in_place_index<0>, s});
+   }
+   keys.push_back(alaio::webauthn_public_key{{}, {}, "example.com"});
+   auto key_strings = alaio::public_keys_to_string(keys);
+   auto sig_strings = alaio::signatures_to_string(sigs);
+   CHECK(key_strings.size() == keys.size() && sig_strings.size() == sigs.size());
+   for(std::size_t i = 0; i < keys.size(); ++i)
+      CHECK(key_strings[i] == alaio::public_key_to_string(keys[i]));
+   for(std::size_t i = 0; i < sigs.size(); ++i)
+      CHECK(sig_strings[i] == alaio::signature_to_string(sigs[i]));
+}
+
+void test_key_string_cache() {
+   alaio::key_string_cache cache(32);
+   alaio::ecc_public_key k{};
+   k[5] = 7;
+   public_key key{std::in_place_index<0>, k};
+   auto str = alaio::public_key_to_string(key);
+   CHECK(cache.to_string(key) == str);
+   CHECK(cache.to_string(key) == str);
+   CHECK(cache.from_string(str) == key);
+   CHECK(cache.from_string(str) == key);
+   CHECK(cache.hits() == 2 && cache.misses() == 2);
+
+   alaio::set_key_string_cache(&cache);
+   CHECK(alaio::convert_to_json(key) == "\"" + str + "\"");
+   CHECK(cache.hits() == 3);
+   for(int i = 0; i < 100; ++i) {
+      k[0] = i;
+      public_key other{std::in_place_index<1>, k};
+      CHECK(cache.to_string(other) == alaio::public_key_to_string(other));
+   }
+   alaio::set_key_string_cache(nullptr);
+   CHECK(cache.hits() == 3 && cache.misses() == 102);
+
+   // a working set larger than the cache still hits often; full shards lose one entry at a time
+   alaio::key_string_cache small(256);
+   uint64_t second_pass_hits = 0;
+   for(int pass = 0; pass < 2; ++pass) {
+      auto hits = small.hits();
+      for(int i = 0; i < 384; ++i) {
+         k[0] = i;
+         k[1] = i >> 8;
+         small.to_string(public_key{std::in_place_index<0>, k});
+      }
+      second_pass_hits = small.hits() - hits;
+   }
+   CHECK(second_pass_hits > 96);
+}
+
+void test_name_codec() {
+   auto reference = [](uint64_t value) {
+      std::string str(13, '.');
+      for(int i = 0; i <= 12; ++i) {
+         str[12 - i] = ".12345abcdefghijklmnopqrstuvwxyz"[value & (i == 0 ? 0x0f : 0x1f)];
+         value >>= (i == 0 ? 4 : 5);
+      }
+      return str.substr(0, str.find_last_not_of('.') + 1);
+   };
+   uint64_t value = 0x9e3779b97f4a7c15;
+   for(int i = 0; i < 1000; ++i) {
+      value = value * 6364136223846793005 + 1442695040888963407;
+      for(uint64_t v : {value, value & ~uint64_t(0xf), value << (i % 64), uint64_t(1) << (i % 64)}) {
+         auto str = alaio::name_to_string(v);
+         CHECK(str == reference(v));
+         CHECK(alaio::string_to_name(str.c_str(), str.size()) == v);
+      }
+   }
+   CHECK(alaio::name_to_string(0).empty());
+   CHECK(alaio::name_to_string(alaio::string_to_name("zzzzzzzzzzzzj")) == "zzzzzzzzzzzzj");
+   CHECK(alaio::convert_to_json(alaio::name{"alaio.token"}) == "\"alaio.token\"");
+   CHECK(alaio::convert_to_json(alaio::name{}) == "\"\"");
+   std::string_view strs[] = {"alaio", "", "a.b.c1", "zzzzzzzzzzzzj"};
+   uint64_t names[4];
+   alaio::string_to_names(strs, 4, names);
+   for(int i = 0; i < 4; ++i)
+      CHECK(names[i] == alaio::string_to_name(strs[i].data(), strs[i].size()));
+}
+
+void test_json_dictionary() {
+   alaio::json_dictionary dictionary(64);
+   std::vector<std::string> expected;
+   alaio::name names[] = {alaio::name{"alaio"}, alaio::name{"alaio.token"}, alaio::name{"zzzzzzzzzzzzj"}, alaio::name{}};
+   for(auto n : names)
+      expected.push_back(alaio::convert_to_json(n));
+   alaio::symbol sym{"ALA", 4};
+   alaio::symbol odd{(uint64_t('"') << 8) | 2};
+   alaio::set_json_dictionary(&dictionary);
+   for(int i = 0; i < 3; ++i) {
+      for(std::size_t j = 0; j < 4; ++j)
+         CHECK(alaio::convert_to_json(names[j]) == expected[j]);
+      CHECK(alaio::convert_to_json(sym) == "\"4,ALA\"");
+      CHECK(alaio::convert_to_json(sym.code()) == "\"ALA\"");
+      CHECK(alaio::convert_to_json(odd) == "\"2,\\\"\"");
+   }
+   CHECK(dictionary.size() == 6);
+   {
+      alaio::json_dictionary_scope scope(nullptr);
+      CHECK(alaio::get_json_dictionary() == &dictionary);
+   }
+   alaio::set_json_dictionary(nullptr);
+   CHECK(alaio::get_json_dictionary() == nullptr);
+   // admission stops at 3/4 of the capacity
+   alaio::json_dictionary small(16);
+   alaio::json_dictionary_scope scope(&small);
+   for(uint64_t i = 1; i < 100; ++i)
+      for(int j = 0; j < 20; ++j)
+         CHECK(alaio::convert_to_json(alaio::name{i}) == "\"" + alaio::name_to_string(i) + "\"");
+   CHECK(small.size() == 12);
+   std::string out;
+   CHECK(alaio::string_stream(out).dictionary == &small);
+
+   // admission thresholds above the saturated count still admit
+   alaio::json_dictionary picky(16, 100);
+   alaio::json_dictionary_scope picky_scope(&picky);
+   for(uint64_t i = 1; i < 20; ++i)
+      for(int j = 0; j < 300; ++j)
+         alaio::convert_to_json(alaio::name{i});
+   CHECK(picky.size() == 12);
+}
+
+void test_time_codec() {
+   CHECK(alaio::microseconds_to_str(0) == "1970-01-01T00:00:00.000");
+   CHECK(alaio::microseconds_to_str(1'592'000'123'456'789) == "2020-06-12T22:15:23.456");
+   CHECK(alaio::microseconds_to_str(1'592'000'123'999'999) == "2020-06-12T22:15:23.999");
+   CHECK(alaio::microseconds_to_str(951'782'400'000'000) == "2000-02-29T00:00:00.000");
+   CHECK(alaio::convert_to_json(alaio::time_point_sec(86399)) == "\"1970-01-01T23:59:59.000\"");
+   CHECK(alaio::convert_to_json(alaio::block_timestamp(1)) == "\"2000-01-01T00:00:00.500\"");
+   uint64_t us = 0;
+   for(int i = 0; i < 10000; ++i) {
+      us += (i % 7 ? 500'000 : 86'400'000'000 * (i % 13)) + i;
+      auto str = alaio::microseconds_to_str(us);
+      uint64_t parsed = 0;
+      CHECK(alaio::string_to_utc_microseconds(parsed, str.data(), str.data() + str.size()));
+      CHECK(parsed == us / 1000 * 1000);
+   }
+   uint32_t sec;
+   for(const char* bad : {"2020-06-12 22:15:23", "2020-6-12T22:15:23", "2020-06-12T22:15:2", "2020-06-12T22:15:2x",
+                          "2020-06-12T22-15:23", "2020-0/-12T22:15:23"})
+      CHECK(!alaio::string_to_utc_seconds(sec, bad, bad + strlen(bad)));
+   std::string_view fractional = "2020-06-12T22:15:23.5";
+   CHECK(alaio::string_to_utc_seconds(sec, fractional.data(), fractional.data() + fractional.size()) &&
+         sec == 1'592'000'123);
+}
+
+void test_varuint_decode() {
+   std::vector<alaio::varuint32> values;
+   for(uint32_t v : {0u, 1u, 127u, 128u, 16383u, 16384u, 0x0fff'ffffu, 0x1000'0000u, 0xffff'ffffu})
+      for(int i = 0; i < 9; ++i)
+         values.push_back(i % 3 ? uint32_t(i) : v);
+   auto bin = alaio::convert_to_bin(values);
+   bin.resize(bin.size() + 8);
+   alaio::input_stream stream{bin.data(), bin.size()};
+   std::vector<alaio::varuint32> decoded;
+   alaio::from_bin(decoded, stream);
+   CHECK(decoded.size() == values.size() && stream.remaining() == 8);
+   for(std::size_t i = 0; i < values.size(); ++i)
+      CHECK(decoded[i].value == values[i].value);
+   for(uint64_t v : {uint64_t(0), uint64_t(1) << 55, (uint64_t(1) << 56) - 1, uint64_t(1) << 56, ~uint64_t(0)}) {
+      std::vector<char> b;
+      for(uint64_t x = v; b.empty() || x; x >>= 7)
+         b.push_back(char((x & 0x7f) | (x >> 7 ? 0x80 : 0)));
+      b.resize(b.size() + 8);
+      alaio::input_stream s{b.data(), b.size()};
+      uint64_t result;
+      alaio::varuint64_from_bin(result, s);
+      CHECK(result == v && s.remaining() == 8);
+   }
+   const char too_long[] = "\x80\x80\x80\x80\x80\x01\0\0\0";
+   alaio::input_stream s{too_long, sizeof(too_long)};
+   uint32_t result;
+   try {
+      alaio::varuint32_from_bin(result, s);
+      CHECK(false);
+   } catch(std::exception&) {}
+
+   // a count larger than the input is rejected before anything is allocated
+   const char huge[] = "\xff\xff\xff\xff\x0f";
+   alaio::input_stream huge_stream{huge, sizeof(huge) - 1};
+   std::vector<alaio::varuint32> rejected;
+   try {
+      alaio::from_bin(rejected, huge_stream);
+      CHECK(false);
+   } catch(std::exception&) {}
+   CHECK(rejected.capacity() == 0);
+}
+
+void test_scatter_stream() {
+   std::string traces(1000, 't');
+   forwarded_struct obj{7, alaio::input_stream{traces}, "short", alaio::bytes{std::vector<char>(300, 'd')}};
+   alaio::scatter_stream stream;
+   alaio::to_bin(obj, stream);
+   auto& segments = stream.segments();
+   // copied header, traces, copied note and size, deltas
+   CHECK(segments.size() == 4);
+   CHECK(segments[1].data == traces.data() && segments[1].size == traces.size());
+   CHECK(segments[3].data == obj.deltas.data.data() && segments[3].size == 300);
+   std::vector<char> joined;
+   for(auto& segment : segments)
+      joined.insert(joined.end(), segment.data, segment.data + segment.size);
+   CHECK(joined == alaio::convert_to_bin(obj) && stream.size() == joined.size());
+   alaio::scatter_stream copying(2000);
+   alaio::to_bin(obj, copying);
+   CHECK(copying.segments().size() == 1 && copying.size() == joined.size());
+   stream.clear();
+   CHECK(stream.size() == 0 && stream.segments().empty());
+
+   // temporaries such as a checksum512's byte array are copied whatever the threshold asked for
+   alaio::scatter_stream eager(1);
+   CHECK(eager.reference_threshold() == alaio::scatter_stream::min_reference_threshold);
+   alaio::checksum512 digest{std::array<uint8_t, 64>{1, 2, 3}};
+   alaio::to_bin(digest, eager);
+   CHECK(eager.segments().size() == 1 && eager.segments()[0].data[2] == 3);
+}
+
 int main() {
+   test_decimal_binary();
+   test_scatter_stream();
+   test_varuint_decode();
+   test_asset_codec();
+   test_time_codec();
+   test_json_dictionary();
+   test_name_codec();
+   test_from_json_key_order();
+   test_key_string_cache();
+   test_batch_key_strings();
+   test_base58();
+   test_number_parse();
+   test_number_format();
+   test_to_json_keys();
    alaio::json_token_stream stream(empty_abi);
    alaio::abi_def def = alaio::from_json<alaio::abi_def>(stream);
    alaio::abi abi;
    convert(def, abi);
    abi.add_type<struct_type>();
+   abi.add_type<string_view_struct>();
    alaio::abi new_abi(round_trip_abi(abi));
    test(true, abi, new_abi);
    test(false, abi, new_abi);
@@ -214,6 +641,9 @@ int main() {
    test("\0"s, abi, new_abi);
    // test("\xff"s, abi, new_abi); // invalid utf8 doesn't round-trip
    test("abcdefghijklmnopqrstuvwxyz"s, abi, new_abi);
+   using namespace std::literals::string_view_literals;
+   test(""sv, abi, new_abi);
+   test("a\"b\\c"sv, abi, new_abi);
    test(checksum160{{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}}, abi, new_abi);
    test(checksum256{{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
                      0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}}, abi, new_abi);
@@ -237,6 +667,8 @@ int main() {
    test(struct_type{}, abi, new_abi);
    test(struct_type{{1},2,3}, abi, new_abi);
    test(struct_type{{1,2},3,4.0}, abi, new_abi);
+   test(string_view_struct{}, abi, new_abi);
+   test(string_view_struct{"abc", "def"}, abi, new_abi);
    test(std::vector{1, 2}, abi, new_abi);
    test(std::optional{3}, abi, new_abi);
    test(std::variant<int, double>{4}, abi, new_abi);
@@ -936,6 +936,10 @@ void check_types() {
     check_type(
         context, 0, "signature",
         R"("SIG_WA_FejsRu4VrdwoZ27v2D3wmp4Kge46JJSqWsiMgbJapVuuYnPDyZZjJSTggdHUNPMp3zt2fGfAdpWY7ScsohZzWTJ1iTerbab2pNE6Tso7MJRjdMAG56K4fjrASEK6QsUs7rxG9Syp7kstBcq8eZidayrtK9YSH1MCNTAqrDPMbN366vR8q5XeN5BSDmyDsqmjsMMSKWMeEbUi7jNHKLziZY6dKHNqDYqjmDmuXoevxyDRWrNVHjAzvBtfTuVtj2r5tCScdCZ3a7yQ1D2zZvstphB4t5HN9YXw1HGS3yKCY6uRZ2V")");
+    check_type(
+        context, 0, "signature[]",
+        R"(["SIG_K1_Kg2UKjXTX48gw2wWH4zmsZmWu3yarcfC21Bd9JPj7QoDURqiAacCHmtExPk3syPb2tFLsp1R4ttXLXgr7FYgDvKPC5RCkx","SIG_R1_Kfh19CfEcQ6pxkMBz6xe9mtqKuPooaoyatPYWtwXbtwHUHU8YLzxPGvZhkqgnp82J41e9R6r5mcpnxy1wAf1w9Vyo9wybZ","SIG_WA_FjWGWXz7AC54NrVWXS8y8DGu1aesCr7oFiFmVg4a1QfNS74JwaVkqkN8xbMD64uvcsmPvtNnA9du6G6nSsWuyT9tM8CQw9mV1BSbWEs8hjF1uFBP1QHAEadvhkZQPU1FTyPMz4jevaHYMQgfMiAf3QoPhPn9RGxzvNph8Zrd6F3pKpZkUe92tGQU8PQvEMa22ELPvdXzxXC6qUKnKVSH4gK7BXw168jb5d3nnWrpQ1yrLTWB4xizEMpN8sTfsgScKKx1QajX2uNUahQEb1cxipQZbVMApifHEUsK45PqsNxfXvb"])");
+    check_type(context, 0, "signature[]", R"([])");
     check_error(context, "expected string containing signature",
                 [&] { return abiala_json_to_bin(context, 0, "signature", "true"); });
     check_error(context, "unrecognized signature format",
@@ -1238,10 +1242,74 @@ void check_types() {
     abiala_destroy(context);
 }
 
+void check_abi_history() {
+    const char* abi_v1 = R"({"version":"alaio::abi/1.1","structs":[{"name":"transfer","base":"","fields":[
+        {"name":"from","type":"name"},{"name":"amount","type":"uint64"}]}],
+        "actions":[{"name":"transfer","type":"transfer","ricardian_contract":""}]})";
+    const char* abi_v2 = R"({"version":"alaio::abi/1.1","structs":[{"name":"transfer2","base":"","fields":[
+        {"name":"from","type":"name"},{"name":"amount","type":"uint64"},{"name":"memo","type":"string"}]}],
+        "actions":[{"name":"transfer","type":"transfer2","ricardian_contract":""}]})";
+
+    auto context = check(abiala_create());
+    auto token = check_context(context, abiala_string_to_name(context, "alaio.token"));
+    auto other = check_context(context, abiala_string_to_name(context, "other"));
+    auto transfer = check_context(context, abiala_string_to_name(context, "transfer"));
+    check_context(context, abiala_set_abi_at(context, token, 10, abi_v1));
+    check_context(context, abiala_set_abi_at(context, token, 20, abi_v2));
+    check_context(context, abiala_set_abi_at(context, other, 30, abi_v1));
+
+    auto check_at = [&](uint64_t contract, uint32_t block_num, const char* json) {
+        std::string type = check_context(context, abiala_get_type_for_action_at(context, contract, block_num, transfer));
+        check_context(context, abiala_json_to_bin_at(context, contract, block_num, type.c_str(), json));
+        std::string hex = check_context(context, abiala_get_bin_hex(context));
+        std::string result =
+              check_context(context, abiala_hex_to_json_at(context, contract, block_num, type.c_str(), hex.c_str()));
+        if (result != json)
+            throw std::runtime_error("abi history mismatch: " + result);
+    };
+    auto check_type_at = [&](uint64_t contract, uint32_t block_num, const std::string& expected) {
+        std::string type = check_context(context, abiala_get_type_for_action_at(context, contract, block_num, transfer));
+        if (type != expected)
+            throw std::runtime_error("abi history type mismatch: " + type);
+    };
+
+    check_type_at(token, 10, "transfer");
+    check_type_at(token, 19, "transfer");
+    check_type_at(token, 20, "transfer2");
+    check_type_at(other, 1000, "transfer");
+    check_at(token, 15, R"({"from":"alice","amount":"5"})");
+    check_at(token, 25, R"({"from":"alice","amount":"5","memo":"hi"})");
+    check_error(context, "contract \"alaio.token\" has no abi at block 9",
+                [&] { return abiala_get_type_for_action_at(context, token, 9, transfer); });
+    check_error(context, "contract \"other\" has no abi at block 29",
+                [&] { return abiala_json_to_bin_at(context, other, 29, "transfer", "{}"); });
+
+    // every lookup recompiles once nothing fits the limit
+    abiala_set_abi_memory_limit(context, 1);
+    check_at(token, 15, R"({"from":"bob","amount":"6"})");
+    check_at(token, 25, R"({"from":"bob","amount":"6","memo":""})");
+    check_at(other, 30, R"({"from":"bob","amount":"6"})");
+
+    // names are served from the dictionary once admitted
+    abiala_set_json_dictionary(context, 64);
+    for (int i = 0; i < 3; ++i)
+        check_at(token, 15, R"({"from":"bob","amount":"6"})");
+    abiala_set_json_dictionary(context, 0);
+    check_at(token, 15, R"({"from":"carol","amount":"7"})");
+
+    // replacing a version at the same block
+    check_context(context, abiala_set_abi_at(context, token, 10, abi_v2));
+    check_type_at(token, 10, "transfer2");
+
+    abiala_destroy(context);
+}
+
 int main() {
     try {
         check_types();
         printf("\ncheck_types ok\n\n");
+        check_abi_history();
+        printf("check_abi_history ok\n\n");
         return 0;
     } catch (std::exception& e) {
         printf("error: %s\n", e.what());